@@ -27,5 +27,8 @@ C:/VulkanSDK/1.3.246.1/Bin/glslc.exe shaders/pbrTexture.frag -o shaders/pbrTextu
 
 C:/VulkanSDK/1.3.246.1/Bin/glslc.exe shaders/pbrModel.vert -o shaders/pbrModelVert.spv
 C:/VulkanSDK/1.3.246.1/Bin/glslc.exe shaders/pbrModel.frag -o shaders/pbrModelFrag.spv
+C:/VulkanSDK/1.3.246.1/Bin/glslc.exe shaders/pbrModelBindless.frag -o shaders/pbrModelBindlessFrag.spv
+
+C:/VulkanSDK/1.3.246.1/Bin/glslc.exe shaders/cull.comp -o shaders/cullComp.spv
 
 pause
\ No newline at end of file
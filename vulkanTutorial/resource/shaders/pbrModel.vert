@@ -18,14 +18,16 @@ layout(set = 0, binding = 0) uniform UniformBufferObject
     vec3 Pos;
 } ubo;
 
-layout(set = 1, binding = 0) uniform UniformBufferModelMatrix {
-    mat4 modelMatrix;
-} modelUBO;
+//world matrix per draw, indexed by the firstInstance of each draw
+layout(std430, set = 1, binding = 0) readonly buffer DrawMatrices {
+    mat4 modelMatrix[];
+} draws;
 
 void main() {
     vCoord = aCoord;   
-    vWorldPos = vec3(ubo.model * modelUBO.modelMatrix * vec4(aPosition, 1.0));
-    mat4 inverseTranspose = transpose(inverse(ubo.model * modelUBO.modelMatrix));
+    mat4 modelMatrix = draws.modelMatrix[gl_InstanceIndex];
+    vWorldPos = vec3(ubo.model * modelMatrix * vec4(aPosition, 1.0));
+    mat4 inverseTranspose = transpose(inverse(ubo.model * modelMatrix));
     vNormal = mat3(inverseTranspose) * aNormal;
     vTangent =  inverseTranspose * aTangent;
     gl_Position = ubo.proj * ubo.view  * vec4(vWorldPos, 1.0);
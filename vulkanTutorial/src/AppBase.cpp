@@ -2,7 +2,7 @@
 
 AppBase* AppBase::m_Instance = nullptr;
 
-AppBase::AppBase(int width, int height, const char* title):m_Window(width, height, title)
+AppBase::AppBase(int width, int height, const char* title, bool headless) : m_Window(headless ? Window() : Window(width, height, title)), m_Headless(headless), m_Width(width), m_Height(height)
 {
 	m_Instance = this;
 }
@@ -1,18 +1,38 @@
 #pragma once
 #include "Window.h"
 
+class Device;
+struct CullStats;
+
 class AppBase
 {
 public:
-	AppBase(int width, int height, const char* title);
+	AppBase(int width, int height, const char* title, bool headless = false);
 	void InitWindow(int width, int height, const char* title);
 	virtual~AppBase() = default;
+	//called after the swapchain was recreated without waiting for the gpu, size dependent objects still in use go through the device's deletion queue
 	virtual void RebuildFrameBuffer() = 0;
 	virtual void CreateSetLayout() = 0;
+	//driven by the benchmark harness instead of the app's own render loop
+	virtual void InitContext() = 0;
+	virtual void RenderFrame() = 0;
+	virtual void WaitIdle() = 0;
+	virtual void Clear() = 0;
+	virtual void SetCameraPath(float t) {}
+	virtual Device* GetDevice() { return nullptr; }
+	//frustum culling of the last CPU culled frame, null when the app doesn't cull
+	virtual const CullStats* GetCullStats() { return nullptr; }
 	static AppBase& Get() { return *m_Instance; }
 	Window& GetWindow() { return m_Window; }
+	bool IsHeadless() const { return m_Headless; }
+	uint32_t GetWidth() const { return m_Width; }
+	uint32_t GetHeight() const { return m_Height; }
 protected:
+	//headless apps never create a glfw window
 	Window m_Window;
+	bool m_Headless = false;
+	uint32_t m_Width = 0;
+	uint32_t m_Height = 0;
 private:
 	static AppBase* m_Instance;
 };
\ No newline at end of file
@@ -1,6 +1,8 @@
 #pragma once
 #include <iostream>
+#ifdef _WIN32
 #define VK_USE_PLATFORM_WIN32_KHR
+#endif
 #include <vulkan/vulkan.hpp>
 
 #define VK_CHECK_RESULT(f)																				\
@@ -1,4 +1,5 @@
 #include "Window.h"
+#include "core/JobSystem.h"
 #include <stdexcept>
 
 
@@ -22,8 +23,11 @@ Window::Window(int width, int height, const char* title)
 
 Window::~Window()
 {
-	glfwDestroyWindow(m_NativeWindow);
-	glfwTerminate();
+	if (m_NativeWindow)
+	{
+		glfwDestroyWindow(m_NativeWindow);
+		glfwTerminate();
+	}
 }
 
 bool Window::ShouldClose()
@@ -38,5 +42,5 @@ void Window::PollEvents()
 
 void Window::GetFrameBufferSize(int* width, int* height) const
 {
-	glfwGetFramebufferSize(m_NativeWindow, width, height);
+	JobSystem::Get().CallMain([&]() { glfwGetFramebufferSize(m_NativeWindow, width, height); });
 }
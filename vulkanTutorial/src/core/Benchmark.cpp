@@ -0,0 +1,426 @@
+#include "../Core.h"
+#include "Benchmark.h"
+#include "../examples/Examples.h"
+#include "../vulkan/Device.h"
+#include "../vulkan/DrawList.h"
+#include "Frustum.h"
+#include "JobSystem.h"
+#include "json.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <random>
+#include <thread>
+
+using Clock = std::chrono::high_resolution_clock;
+
+static double ElapsedMs(Clock::time_point start, Clock::time_point end)
+{
+	return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+static double Percentile(const std::vector<double>& sorted, double p)
+{
+	size_t index = static_cast<size_t>(std::ceil(sorted.size() * p));
+	return sorted[index > 0 ? index - 1 : 0];
+}
+
+static nlohmann::json ToJson(const BenchmarkResult& result, const BenchmarkConfig& config, Device* device)
+{
+	nlohmann::json report;
+	report["example"] = result.Example;
+	report["width"] = config.Width;
+	report["height"] = config.Height;
+	report["headless"] = config.Headless;
+	report["warmup_frames"] = config.WarmupFrames;
+	report["measured_frames"] = config.MeasuredFrames;
+	if (device)
+	{
+		report["device"] = std::string(device->GetProperties().deviceName.data());
+	}
+	report["load_ms"] = result.LoadMs;
+	report["frame_ms"] = {
+		{ "min", result.MinMs },
+		{ "avg", result.AvgMs },
+		{ "p50", result.P50Ms },
+		{ "p99", result.P99Ms },
+		{ "max", result.MaxMs }
+	};
+	report["fps"] = result.AvgMs > 0.0 ? 1000.0 / result.AvgMs : 0.0;
+	report["rebuild_ms"] = {
+		{ "avg", result.RebuildAvgMs },
+		{ "max", result.RebuildMaxMs }
+	};
+	report["memory"] = {
+		{ "peak_reserved_bytes", result.PeakReservedBytes },
+		{ "live_bytes", result.LiveBytes },
+		{ "allocations", result.AllocationCount },
+		{ "device_allocations", result.DeviceAllocationCount }
+	};
+	if (result.CullTested > 0)
+	{
+		report["culling"] = {
+			{ "tested", result.CullTested },
+			{ "visible_avg", result.CullVisibleAvg }
+		};
+	}
+	report["frames"] = result.FrameMs;
+	if (device)
+	{
+		nlohmann::json scopes = nlohmann::json::array();
+		for (auto& stats : device->GetProfiler().GetStats())
+		{
+			scopes.push_back({ { "name", stats.Name }, { "timeline", stats.Gpu ? "gpu" : "cpu" }, { "avg_ms", stats.Avg }, { "p99_ms", stats.P99 } });
+		}
+		report["scopes"] = scopes;
+	}
+	return report;
+}
+
+//a report value where a higher value is a regression
+struct BaselineMetric
+{
+	std::vector<std::string> Path;
+	//allowed increase, negative takes the configured tolerance; counts that must never grow use 0
+	double Tolerance = -1.0;
+};
+
+//a missing baseline or a metric the baseline lacks fails the run
+static bool CompareBaseline(const nlohmann::json& report, const std::string& baselinePath, double tolerance, const std::vector<BaselineMetric>& metrics)
+{
+	std::ifstream file(baselinePath);
+	if (!file.is_open())
+	{
+		std::cout << "baseline " << baselinePath << " not found, run with --update-baseline to create it" << std::endl;
+		return false;
+	}
+	nlohmann::json baseline = nlohmann::json::parse(file, nullptr, false);
+	if (baseline.is_discarded())
+	{
+		std::cout << "baseline " << baselinePath << " is not valid json" << std::endl;
+		return false;
+	}
+	bool passed = true;
+	for (auto& metric : metrics)
+	{
+		const nlohmann::json* current = &report;
+		const nlohmann::json* expected = &baseline;
+		std::string name;
+		for (auto& key : metric.Path)
+		{
+			name += name.empty() ? key : "." + key;
+			current = current->contains(key) ? &(*current)[key] : nullptr;
+			expected = expected && expected->contains(key) ? &(*expected)[key] : nullptr;
+			if (!current)
+			{
+				break;
+			}
+		}
+		//not produced by this example
+		if (!current)
+		{
+			continue;
+		}
+		if (!expected || !expected->is_number())
+		{
+			std::cout << "NEW METRIC " << name << ": " << *current << " (not in baseline, run with --update-baseline)" << std::endl;
+			passed = false;
+			continue;
+		}
+		double value = current->get<double>();
+		double limit = expected->get<double>() * (1.0 + (metric.Tolerance < 0.0 ? tolerance : metric.Tolerance));
+		bool regressed = value > limit;
+		std::cout << (regressed ? "REGRESSION " : "ok ") << name << ": " << value << " (baseline " << expected->get<double>() << ")" << std::endl;
+		passed = passed && !regressed;
+	}
+	return passed;
+}
+
+static int WriteReport(const nlohmann::json& report, const BenchmarkConfig& config, const std::vector<BaselineMetric>& metrics)
+{
+	if (!config.ReportPath.empty())
+	{
+		std::ofstream file(config.ReportPath, std::ios::trunc);
+		if (!file.is_open())
+		{
+			std::cout << "failed to open " << config.ReportPath << std::endl;
+			return 1;
+		}
+		file << report.dump(4);
+	}
+	if (config.BaselinePath.empty())
+	{
+		return 0;
+	}
+	if (config.UpdateBaseline)
+	{
+		std::ofstream file(config.BaselinePath, std::ios::trunc);
+		if (!file.is_open())
+		{
+			std::cout << "failed to open " << config.BaselinePath << std::endl;
+			return 1;
+		}
+		file << report.dump(4);
+		std::cout << "baseline " << config.BaselinePath << " updated" << std::endl;
+		return 0;
+	}
+	return CompareBaseline(report, config.BaselinePath, config.Tolerance, metrics) ? 0 : 1;
+}
+
+//best of a few runs of fn, in nanoseconds per item
+static double MeasureNs(uint32_t items, const std::function<void()>& fn)
+{
+	double best = 0.0;
+	for (uint32_t run = 0; run < 8; run++)
+	{
+		auto start = Clock::now();
+		fn();
+		double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count() / items;
+		best = run == 0 ? ns : (std::min)(best, ns);
+	}
+	return best;
+}
+
+static int RunJobBenchmark(const BenchmarkConfig& config)
+{
+	JobSystem& jobs = JobSystem::Get();
+	const uint32_t jobCount = 100000;
+	const uint32_t chainLength = 1000;
+	std::atomic<uint64_t> sink{ 0 };
+
+	//submit and wait on empty jobs from the main thread, which helps in Wait
+	double spawnNs = MeasureNs(jobCount, [&]() {
+		JobCounter counter;
+		for (uint32_t i = 0; i < jobCount; i++)
+		{
+			jobs.Submit([]() {}, &counter);
+		}
+		jobs.Wait(counter);
+	});
+
+	//the main thread only fills its deque and watches, every job is stolen by a worker
+	const uint32_t stealCount = 4000;
+	JobSystemStats before = jobs.GetStats();
+	double stealNs = MeasureNs(stealCount, [&]() {
+		JobCounter counter;
+		for (uint32_t i = 0; i < stealCount; i++)
+		{
+			jobs.Submit([&sink]() { sink.fetch_add(1, std::memory_order_relaxed); }, &counter);
+		}
+		while (counter.Pending.load() > 0)
+		{
+			std::this_thread::yield();
+		}
+	});
+	uint64_t stolen = jobs.GetStats().Stolen - before.Stolen;
+
+	//cost of splitting and joining a loop whose body does nothing
+	double parallelForNs = MeasureNs(1, [&]() {
+		jobs.ParallelFor(jobCount, 0, [&sink](uint32_t first, uint32_t last) {
+			sink.fetch_add(last - first, std::memory_order_relaxed);
+		});
+	});
+
+	//latency of a job that waits on the previous one through its counter
+	double dependencyNs = MeasureNs(chainLength, [&]() {
+		std::vector<JobCounter> chain(chainLength);
+		jobs.Submit([]() {}, &chain[0]);
+		for (uint32_t i = 1; i < chainLength; i++)
+		{
+			jobs.Submit([]() {}, chain[i - 1], &chain[i]);
+		}
+		jobs.Wait(chain[chainLength - 1]);
+	});
+
+	nlohmann::json report;
+	report["example"] = "jobs";
+	report["workers"] = jobs.GetWorkerCount();
+	report["jobs"] = {
+		{ "spawn_ns", spawnNs },
+		{ "steal_ns", stealNs },
+		{ "stolen", stolen },
+		{ "parallel_for_us", parallelForNs / 1000.0 },
+		{ "dependency_ns", dependencyNs }
+	};
+	std::cout << "jobs: " << jobs.GetWorkerCount() << " workers, spawn " << spawnNs << " ns, steal " << stealNs << " ns, parallel for " << parallelForNs / 1000.0
+			  << " us, dependency " << dependencyNs << " ns" << std::endl;
+	return WriteReport(report, config, {
+		{ { "jobs", "spawn_ns" } },
+		{ { "jobs", "steal_ns" } },
+		{ { "jobs", "parallel_for_us" } },
+		{ { "jobs", "dependency_ns" } }
+	});
+}
+
+static int RunDrawListBenchmark(const BenchmarkConfig& config)
+{
+	//a scene sized list: a few pipelines, a few hundred materials, packets added in random order
+	const uint32_t packetCount = 5000;
+	const uint32_t pipelineCount = 4;
+	const uint32_t materialCount = 300;
+	std::mt19937 random(1234);
+	std::vector<vk::Pipeline> pipelines;
+	std::vector<vk::DescriptorSet> sets;
+	for (uint32_t i = 0; i < pipelineCount; i++)
+	{
+		//never bound, only compared
+		pipelines.push_back(vk::Pipeline(reinterpret_cast<VkPipeline>(static_cast<uintptr_t>(i + 1))));
+	}
+	for (uint32_t i = 0; i < materialCount; i++)
+	{
+		sets.push_back(vk::DescriptorSet(reinterpret_cast<VkDescriptorSet>(static_cast<uintptr_t>(i + 1))));
+	}
+	struct Input
+	{
+		uint32_t Pipeline;
+		uint32_t Material;
+		uint32_t FirstIndex;
+	};
+	std::vector<Input> inputs(packetCount);
+	for (auto& input : inputs)
+	{
+		input = { static_cast<uint32_t>(random() % pipelineCount), static_cast<uint32_t>(random() % materialCount), static_cast<uint32_t>(random() % 1000000) };
+	}
+
+	DrawList list;
+	auto build = [&]() {
+		list.Reset();
+		for (uint32_t i = 0; i < packetCount; i++)
+		{
+			const Input& input = inputs[i];
+			list.Add(pipelines[input.Pipeline], sets[input.Material], input.Material, input.FirstIndex, 36, i);
+		}
+	};
+	double addNs = MeasureNs(packetCount, build);
+	//the radix sort does the same passes whatever the input order, so repeated sorts of the built list are representative
+	double sortNs = MeasureNs(packetCount, [&]() { list.Sort(); });
+
+	nlohmann::json report;
+	report["example"] = "drawlist";
+	report["drawlist"] = {
+		{ "packets", packetCount },
+		{ "add_ns", addNs },
+		{ "sort_ns", sortNs },
+		{ "add_sort_us", (addNs + sortNs) * packetCount / 1000.0 }
+	};
+	std::cout << "drawlist: " << packetCount << " packets, add " << addNs << " ns, sort " << sortNs << " ns per packet, add + sort " << (addNs + sortNs) * packetCount / 1000.0 << " us" << std::endl;
+	return WriteReport(report, config, {
+		{ { "drawlist", "add_ns" } },
+		{ { "drawlist", "sort_ns" } },
+		{ { "drawlist", "add_sort_us" } }
+	});
+}
+
+int RunBenchmark(const BenchmarkConfig& config)
+{
+	if (config.Example == "jobs")
+	{
+		return RunJobBenchmark(config);
+	}
+	if (config.Example == "drawlist")
+	{
+		return RunDrawListBenchmark(config);
+	}
+
+	std::unique_ptr<AppBase> app = CreateExample(config.Example, config.Width, config.Height, config.Headless);
+	if (!app)
+	{
+		std::cout << "unknown example " << config.Example << ", available:";
+		for (auto& name : GetExampleNames())
+		{
+			std::cout << " " << name;
+		}
+		std::cout << std::endl;
+		return 2;
+	}
+
+	BenchmarkResult result;
+	result.Example = config.Example;
+
+	auto loadStart = Clock::now();
+	app->InitContext();
+	app->WaitIdle();
+	result.LoadMs = ElapsedMs(loadStart, Clock::now());
+
+	uint32_t totalFrames = config.WarmupFrames + config.MeasuredFrames;
+	for (uint32_t i = 0; i < config.WarmupFrames; i++)
+	{
+		app->SetCameraPath(static_cast<float>(i) / totalFrames);
+		app->RenderFrame();
+	}
+
+	//frame to frame time, with frames in flight this is the pipelined throughput and not one frame's latency
+	result.FrameMs.reserve(config.MeasuredFrames);
+	double visibleSum = 0.0;
+	auto last = Clock::now();
+	for (uint32_t i = 0; i < config.MeasuredFrames; i++)
+	{
+		app->SetCameraPath(static_cast<float>(config.WarmupFrames + i) / totalFrames);
+		app->RenderFrame();
+		auto now = Clock::now();
+		result.FrameMs.push_back(ElapsedMs(last, now));
+		last = now;
+		if (const CullStats* cull = app->GetCullStats())
+		{
+			result.CullTested = cull->Tested;
+			visibleSum += cull->Visible;
+		}
+	}
+	result.CullVisibleAvg = config.MeasuredFrames > 0 ? visibleSum / config.MeasuredFrames : 0.0;
+
+	//a frame after each rebuild lets the replaced objects retire the way they do on a resize
+	double rebuildSum = 0.0;
+	for (uint32_t i = 0; i < config.RebuildCount; i++)
+	{
+		auto rebuildStart = Clock::now();
+		app->RebuildFrameBuffer();
+		double rebuildMs = ElapsedMs(rebuildStart, Clock::now());
+		rebuildSum += rebuildMs;
+		result.RebuildMaxMs = (std::max)(result.RebuildMaxMs, rebuildMs);
+		app->RenderFrame();
+	}
+	result.RebuildAvgMs = config.RebuildCount > 0 ? rebuildSum / config.RebuildCount : 0.0;
+	app->WaitIdle();
+
+	if (!result.FrameMs.empty())
+	{
+		std::vector<double> sorted = result.FrameMs;
+		std::sort(sorted.begin(), sorted.end());
+		double sum = 0.0;
+		for (double frame : sorted)
+		{
+			sum += frame;
+		}
+		result.MinMs = sorted.front();
+		result.MaxMs = sorted.back();
+		result.AvgMs = sum / sorted.size();
+		result.P50Ms = Percentile(sorted, 0.5);
+		result.P99Ms = Percentile(sorted, 0.99);
+	}
+
+	Device* device = app->GetDevice();
+	if (device)
+	{
+		MemoryStats memory = device->GetAllocator().GetStats();
+		result.PeakReservedBytes = memory.PeakReservedBytes;
+		result.LiveBytes = memory.LiveBytes;
+		result.AllocationCount = memory.AllocationCount;
+		result.DeviceAllocationCount = memory.DeviceAllocationCount;
+	}
+
+	nlohmann::json report = ToJson(result, config, device);
+	app->Clear();
+
+	std::cout << config.Example << ": load " << result.LoadMs << " ms, frame avg " << result.AvgMs << " ms, p99 " << result.P99Ms << " ms, rebuild avg " << result.RebuildAvgMs << " ms" << std::endl;
+	return WriteReport(report, config, {
+		{ { "frame_ms", "avg" } },
+		{ { "frame_ms", "p99" } },
+		{ { "load_ms" } },
+		{ { "rebuild_ms", "avg" } },
+		{ { "memory", "peak_reserved_bytes" } },
+		//sub-allocation keeps this at a handful of blocks, a single extra vkAllocateMemory is a regression
+		{ { "memory", "device_allocations" }, 0.0 }
+	});
+}
@@ -0,0 +1,45 @@
+#pragma once
+#include <string>
+#include <vector>
+
+struct BenchmarkConfig
+{
+	std::string Example = "PBRModel";
+	int Width = 1920;
+	int Height = 1080;
+	bool Headless = false;
+	uint32_t WarmupFrames = 60;
+	uint32_t MeasuredFrames = 600;
+	std::string ReportPath = "benchmark.json";
+	std::string BaselinePath;
+	//write the report to BaselinePath instead of comparing against it
+	bool UpdateBaseline = false;
+	//allowed slowdown against the baseline before the run fails, 0.1 = 10%
+	double Tolerance = 0.1;
+	//size dependent objects rebuilt this many times after the measured frames, as on a resize
+	uint32_t RebuildCount = 16;
+};
+
+struct BenchmarkResult
+{
+	std::string Example;
+	double LoadMs = 0.0;
+	std::vector<double> FrameMs;
+	double MinMs = 0.0;
+	double AvgMs = 0.0;
+	double P50Ms = 0.0;
+	double P99Ms = 0.0;
+	double MaxMs = 0.0;
+	double RebuildAvgMs = 0.0;
+	double RebuildMaxMs = 0.0;
+	uint64_t PeakReservedBytes = 0;
+	uint64_t LiveBytes = 0;
+	uint32_t AllocationCount = 0;
+	uint32_t DeviceAllocationCount = 0;
+	//CPU frustum culling over the measured frames, zero when the example culls on the GPU or not at all
+	uint32_t CullTested = 0;
+	double CullVisibleAvg = 0.0;
+};
+
+//runs one example for warmup + measured frames on a scripted camera path, returns the process exit code
+int RunBenchmark(const BenchmarkConfig& config);
@@ -43,6 +43,15 @@ void EditorCamera::OnUpdate()
 	}
 }
 
+void EditorCamera::SetOrbit(const glm::vec3& focalPoint, float yaw, float pitch, float distance)
+{
+	m_FocalPoint = focalPoint;
+	m_Yaw = yaw;
+	m_Pitch = pitch;
+	m_Distance = distance;
+	UpdateView();
+}
+
 //void EditorCamera::OnEvent(Event& e)
 //{
 //	EventDispatcher dispatcher(e);
@@ -18,12 +18,14 @@ public:
 	}
 	const glm::mat4& GetViewMatrix() const { return m_View; }
 	const glm::mat4& GetProjection() const { return m_Projection; }
-	const glm::mat4& GetViewProjectionMatrix() const { return m_Projection * m_View; }
+	glm::mat4 GetViewProjectionMatrix() const { return m_Projection * m_View; }
 	const glm::vec3& GetPosition() const { return m_Position; }
 	void UpdateView();
 	void UpdateProjection();
 
 	void OnUpdate(/*TimeStamp ts*/);
+	//scripted camera for reproducible runs, angles in radians
+	void SetOrbit(const glm::vec3& focalPoint, float yaw, float pitch, float distance);
 	//void OnEvent(Event& e);
 	//bool OnMouseScrollEvent(MouseScrolledEvent& e);
 	//void OnViewportResize(uint32_t width, uint32_t height);
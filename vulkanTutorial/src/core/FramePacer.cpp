@@ -0,0 +1,82 @@
+#include "FramePacer.h"
+#include <thread>
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#endif
+
+using Clock = std::chrono::steady_clock;
+
+//spun instead of slept, covers the wake up latency of the timer
+static constexpr std::chrono::microseconds SpinMargin(500);
+
+FramePacer::FramePacer()
+{
+#ifdef _WIN32
+	m_Timer = CreateWaitableTimerExW(nullptr, nullptr, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+#endif
+}
+
+FramePacer::~FramePacer()
+{
+#ifdef _WIN32
+	if (m_Timer)
+	{
+		CloseHandle(m_Timer);
+	}
+#endif
+}
+
+void FramePacer::SetMaxFps(double maxFps)
+{
+	m_MaxFps = maxFps > 0.0 ? maxFps : 0.0;
+	m_Interval = m_MaxFps > 0.0 ? std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / m_MaxFps)) : Clock::duration(0);
+	m_Next = Clock::now();
+}
+
+void FramePacer::Wait()
+{
+	if (m_MaxFps <= 0.0)
+	{
+		return;
+	}
+	SleepUntil(m_Next);
+	Clock::time_point now = Clock::now();
+	//fixed deadlines keep the average rate exact, a frame that ran long starts a new schedule instead of bursting to catch up
+	m_Next += m_Interval;
+	if (m_Next < now)
+	{
+		m_Next = now + m_Interval;
+	}
+}
+
+void FramePacer::SleepUntil(Clock::time_point deadline)
+{
+	Clock::duration remaining = deadline - Clock::now() - SpinMargin;
+	if (remaining > Clock::duration(0))
+	{
+#ifdef _WIN32
+		if (m_Timer)
+		{
+			//negative due time is relative, in 100ns units
+			LARGE_INTEGER dueTime;
+			dueTime.QuadPart = -static_cast<LONGLONG>(std::chrono::duration_cast<std::chrono::nanoseconds>(remaining).count() / 100);
+			if (SetWaitableTimerEx(m_Timer, &dueTime, 0, nullptr, nullptr, nullptr, 0))
+			{
+				WaitForSingleObject(m_Timer, INFINITE);
+			}
+		}
+		else
+		{
+			std::this_thread::sleep_for(remaining);
+		}
+#else
+		std::this_thread::sleep_for(remaining);
+#endif
+	}
+	while (Clock::now() < deadline)
+	{
+		std::this_thread::yield();
+	}
+}
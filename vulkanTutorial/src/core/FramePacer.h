@@ -0,0 +1,25 @@
+#pragma once
+#include <chrono>
+
+//caps the frame rate: sleeps most of the remaining frame time and spins the last bit, the os sleep alone overshoots by up to a scheduler tick
+class FramePacer
+{
+public:
+	FramePacer();
+	~FramePacer();
+	FramePacer(const FramePacer&) = delete;
+	FramePacer& operator=(const FramePacer&) = delete;
+	//0 turns the cap off
+	void SetMaxFps(double maxFps);
+	double GetMaxFps() const { return m_MaxFps; }
+	//blocks until a frame interval has passed since the previous call
+	void Wait();
+private:
+	void SleepUntil(std::chrono::steady_clock::time_point deadline);
+private:
+	double m_MaxFps = 0.0;
+	std::chrono::steady_clock::duration m_Interval{ 0 };
+	std::chrono::steady_clock::time_point m_Next;
+	//high resolution waitable timer on windows
+	void* m_Timer = nullptr;
+};
@@ -0,0 +1,131 @@
+#include "Frustum.h"
+#include <cmath>
+#include <algorithm>
+
+#if defined(_M_X64) || defined(__x86_64__) || defined(__SSE2__)
+#define FRUSTUM_SSE
+#include <emmintrin.h>
+#endif
+
+Frustum Frustum::FromMatrix(const glm::mat4& matrix)
+{
+	//rows of the matrix, glm stores columns
+	glm::vec4 row0(matrix[0][0], matrix[1][0], matrix[2][0], matrix[3][0]);
+	glm::vec4 row1(matrix[0][1], matrix[1][1], matrix[2][1], matrix[3][1]);
+	glm::vec4 row2(matrix[0][2], matrix[1][2], matrix[2][2], matrix[3][2]);
+	glm::vec4 row3(matrix[0][3], matrix[1][3], matrix[2][3], matrix[3][3]);
+	Frustum frustum;
+	frustum.Planes[0] = row3 + row0;
+	frustum.Planes[1] = row3 - row0;
+	frustum.Planes[2] = row3 + row1;
+	frustum.Planes[3] = row3 - row1;
+	frustum.Planes[4] = row3 + row2;
+	frustum.Planes[5] = row3 - row2;
+	for (auto& plane : frustum.Planes)
+	{
+		plane /= glm::length(glm::vec3(plane));
+	}
+	return frustum;
+}
+
+void BoundsSoA::Resize(size_t count)
+{
+	CenterX.resize(count);
+	CenterY.resize(count);
+	CenterZ.resize(count);
+	ExtentX.resize(count);
+	ExtentY.resize(count);
+	ExtentZ.resize(count);
+	Radius.resize(count);
+}
+
+void BoundsSoA::SetTransformed(size_t index, const glm::vec3& minBounds, const glm::vec3& maxBounds, const glm::mat4& matrix)
+{
+	glm::vec3 center = (minBounds + maxBounds) * 0.5f;
+	glm::vec3 extent = (maxBounds - minBounds) * 0.5f;
+	glm::vec3 worldCenter = glm::vec3(matrix * glm::vec4(center, 1.0f));
+	glm::vec3 worldExtent = glm::abs(glm::vec3(matrix[0])) * extent.x + glm::abs(glm::vec3(matrix[1])) * extent.y + glm::abs(glm::vec3(matrix[2])) * extent.z;
+	CenterX[index] = worldCenter.x;
+	CenterY[index] = worldCenter.y;
+	CenterZ[index] = worldCenter.z;
+	ExtentX[index] = worldExtent.x;
+	ExtentY[index] = worldExtent.y;
+	ExtentZ[index] = worldExtent.z;
+	Radius[index] = glm::length(worldExtent);
+}
+
+static bool IsBoxVisible(const Frustum& frustum, const BoundsSoA& bounds, size_t i)
+{
+	for (auto& plane : frustum.Planes)
+	{
+		float distance = plane.x * bounds.CenterX[i] + plane.y * bounds.CenterY[i] + plane.z * bounds.CenterZ[i] + plane.w;
+		float radius = std::abs(plane.x) * bounds.ExtentX[i] + std::abs(plane.y) * bounds.ExtentY[i] + std::abs(plane.z) * bounds.ExtentZ[i];
+		if (distance + radius < 0.0f)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+uint32_t CullBounds(const Frustum& frustum, const BoundsSoA& bounds, std::vector<uint32_t>& visible)
+{
+	return CullBounds(frustum, bounds, 0, static_cast<uint32_t>(bounds.Size()), visible);
+}
+
+uint32_t CullBounds(const Frustum& frustum, const BoundsSoA& bounds, uint32_t first, uint32_t last, std::vector<uint32_t>& visible)
+{
+	size_t count = last;
+	size_t begin = visible.size();
+	size_t i = first;
+#ifdef FRUSTUM_SSE
+	//4 boxes per iteration: a box is out when center distance plus projected extent is negative for any plane
+	__m128 planeX[6], planeY[6], planeZ[6], planeW[6], absX[6], absY[6], absZ[6];
+	for (uint32_t p = 0; p < 6; p++)
+	{
+		planeX[p] = _mm_set1_ps(frustum.Planes[p].x);
+		planeY[p] = _mm_set1_ps(frustum.Planes[p].y);
+		planeZ[p] = _mm_set1_ps(frustum.Planes[p].z);
+		planeW[p] = _mm_set1_ps(frustum.Planes[p].w);
+		absX[p] = _mm_set1_ps(std::abs(frustum.Planes[p].x));
+		absY[p] = _mm_set1_ps(std::abs(frustum.Planes[p].y));
+		absZ[p] = _mm_set1_ps(std::abs(frustum.Planes[p].z));
+	}
+	const __m128 zero = _mm_setzero_ps();
+	for (; i + 4 <= count; i += 4)
+	{
+		__m128 cx = _mm_loadu_ps(&bounds.CenterX[i]);
+		__m128 cy = _mm_loadu_ps(&bounds.CenterY[i]);
+		__m128 cz = _mm_loadu_ps(&bounds.CenterZ[i]);
+		__m128 ex = _mm_loadu_ps(&bounds.ExtentX[i]);
+		__m128 ey = _mm_loadu_ps(&bounds.ExtentY[i]);
+		__m128 ez = _mm_loadu_ps(&bounds.ExtentZ[i]);
+		__m128 outside = _mm_setzero_ps();
+		for (uint32_t p = 0; p < 6; p++)
+		{
+			__m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(cx, planeX[p]), _mm_mul_ps(cy, planeY[p])), _mm_add_ps(_mm_mul_ps(cz, planeZ[p]), planeW[p]));
+			__m128 radius = _mm_add_ps(_mm_add_ps(_mm_mul_ps(ex, absX[p]), _mm_mul_ps(ey, absY[p])), _mm_mul_ps(ez, absZ[p]));
+			outside = _mm_or_ps(outside, _mm_cmplt_ps(_mm_add_ps(distance, radius), zero));
+		}
+		int mask = ~_mm_movemask_ps(outside) & 0xF;
+		while (mask)
+		{
+			int lane = 0;
+			while (!(mask & (1 << lane)))
+			{
+				lane++;
+			}
+			visible.push_back(static_cast<uint32_t>(i + lane));
+			mask &= mask - 1;
+		}
+	}
+#endif
+	for (; i < count; i++)
+	{
+		if (IsBoxVisible(frustum, bounds, i))
+		{
+			visible.push_back(static_cast<uint32_t>(i));
+		}
+	}
+	return static_cast<uint32_t>(visible.size() - begin);
+}
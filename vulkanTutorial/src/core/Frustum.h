@@ -0,0 +1,36 @@
+#pragma once
+#include <glm.hpp>
+#include <cstdint>
+#include <vector>
+
+//six clip planes as (normal, distance), a point p is inside when dot(normal, p) + distance >= 0
+struct Frustum
+{
+	glm::vec4 Planes[6];
+	//matrix maps the bounds' space to clip space, the near plane is the looser -w <= z so it holds for [0, 1] and [-1, 1] depth
+	static Frustum FromMatrix(const glm::mat4& matrix);
+};
+
+//axis aligned boxes as center/extent plus enclosing spheres, one array per component so 4 boxes load at once
+struct BoundsSoA
+{
+	std::vector<float> CenterX, CenterY, CenterZ;
+	std::vector<float> ExtentX, ExtentY, ExtentZ;
+	std::vector<float> Radius;
+	void Resize(size_t count);
+	size_t Size() const { return CenterX.size(); }
+	//box of minBounds/maxBounds moved by matrix, the result is the box enclosing the transformed box
+	void SetTransformed(size_t index, const glm::vec3& minBounds, const glm::vec3& maxBounds, const glm::mat4& matrix);
+};
+
+struct CullStats
+{
+	uint32_t Tested = 0;
+	uint32_t Visible = 0;
+	uint32_t Culled = 0;
+};
+
+//appends the indices of boxes intersecting the frustum to visible, returns how many were appended
+uint32_t CullBounds(const Frustum& frustum, const BoundsSoA& bounds, std::vector<uint32_t>& visible);
+//same for the boxes in [first, last), so ranges can be culled on separate threads
+uint32_t CullBounds(const Frustum& frustum, const BoundsSoA& bounds, uint32_t first, uint32_t last, std::vector<uint32_t>& visible);
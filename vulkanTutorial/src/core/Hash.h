@@ -0,0 +1,23 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+//64 bit FNV-1a, chain calls by passing the previous result as hash
+constexpr uint64_t HashSeed = 14695981039346656037ull;
+
+inline uint64_t HashBytes(uint64_t hash, const void* data, size_t size)
+{
+	const uint8_t* bytes = static_cast<const uint8_t*>(data);
+	for (size_t i = 0; i < size; i++)
+	{
+		hash ^= bytes[i];
+		hash *= 1099511628211ull;
+	}
+	return hash;
+}
+
+template<typename T>
+inline uint64_t HashValue(uint64_t hash, const T& value)
+{
+	return HashBytes(hash, &value, sizeof(T));
+}
@@ -0,0 +1,494 @@
+#include "JobSystem.h"
+#include <algorithm>
+#include <utility>
+
+static constexpr uint32_t NoSlot = UINT32_MAX;
+//spins before an idle worker goes to sleep
+static constexpr uint32_t IdleSpins = 64;
+
+static thread_local uint32_t t_ThreadIndex = 0;
+//the system whose deque t_Slot refers to, threads of another system or foreign threads have none
+static thread_local JobSystem* t_Owner = nullptr;
+static thread_local uint32_t t_Slot = NoSlot;
+static thread_local uint32_t t_Seed = 0x9E3779B9u;
+
+static uint32_t NextRandom()
+{
+	//xorshift32, only picks steal victims
+	t_Seed ^= t_Seed << 13;
+	t_Seed ^= t_Seed >> 17;
+	t_Seed ^= t_Seed << 5;
+	return t_Seed;
+}
+
+JobSystem::WorkQueue::WorkQueue(uint32_t capacity)
+{
+	m_Buffer.reset(new std::atomic<Job*>[capacity]);
+	m_Mask = static_cast<int64_t>(capacity) - 1;
+}
+
+bool JobSystem::WorkQueue::Push(Job* job)
+{
+	int64_t bottom = m_Bottom.load(std::memory_order_relaxed);
+	int64_t top = m_Top.load(std::memory_order_acquire);
+	if (bottom - top > m_Mask)
+	{
+		return false;
+	}
+	m_Buffer[bottom & m_Mask].store(job, std::memory_order_relaxed);
+	//publishes the job to thieves that acquire m_Bottom
+	m_Bottom.store(bottom + 1, std::memory_order_release);
+	return true;
+}
+
+JobSystem::Job* JobSystem::WorkQueue::Pop()
+{
+	int64_t bottom = m_Bottom.load(std::memory_order_relaxed) - 1;
+	m_Bottom.store(bottom, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	int64_t top = m_Top.load(std::memory_order_relaxed);
+	if (top > bottom)
+	{
+		m_Bottom.store(bottom + 1, std::memory_order_relaxed);
+		return nullptr;
+	}
+	Job* job = m_Buffer[bottom & m_Mask].load(std::memory_order_relaxed);
+	if (top == bottom)
+	{
+		//last job, race the thieves for it
+		if (!m_Top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+		{
+			job = nullptr;
+		}
+		m_Bottom.store(bottom + 1, std::memory_order_relaxed);
+	}
+	return job;
+}
+
+JobSystem::Job* JobSystem::WorkQueue::Steal()
+{
+	int64_t top = m_Top.load(std::memory_order_acquire);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	int64_t bottom = m_Bottom.load(std::memory_order_acquire);
+	if (top >= bottom)
+	{
+		return nullptr;
+	}
+	Job* job = m_Buffer[top & m_Mask].load(std::memory_order_relaxed);
+	if (!m_Top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+	{
+		return nullptr;
+	}
+	return job;
+}
+
+JobSystem& JobSystem::Get()
+{
+	static JobSystem s_Instance;
+	return s_Instance;
+}
+
+JobSystem::JobSystem(uint32_t threadCount)
+{
+	if (threadCount == 0)
+	{
+		//the submitting thread helps out in Wait, so leave it a core
+		uint32_t cores = std::thread::hardware_concurrency();
+		threadCount = cores > 1 ? cores - 1 : 1;
+	}
+	m_MainThread = std::this_thread::get_id();
+	for (uint32_t i = 0; i <= threadCount; i++)
+	{
+		m_Threads.push_back(std::make_unique<ThreadState>());
+	}
+	t_Owner = this;
+	t_Slot = 0;
+	m_Workers.reserve(threadCount);
+	for (uint32_t i = 0; i < threadCount; i++)
+	{
+		m_Workers.emplace_back(&JobSystem::WorkerLoop, this, i + 1);
+	}
+}
+
+JobSystem::~JobSystem()
+{
+	m_Stop.store(true);
+	{
+		std::lock_guard<std::mutex> lock(m_SleepMutex);
+	}
+	m_Condition.notify_all();
+	for (auto& worker : m_Workers)
+	{
+		worker.join();
+	}
+	//the destroying thread drains what is still queued, jobs may queue more as they run
+	bool ran = true;
+	while (ran)
+	{
+		ran = false;
+		while (RunPending())
+		{
+			ran = true;
+		}
+		if (IsMainThread() && HasMainJobs())
+		{
+			RunMainThreadJobs();
+			ran = true;
+		}
+	}
+	//main thread jobs left by a destructor on another thread, and jobs whose dependency never finished
+	for (auto job : m_MainJobs)
+	{
+		delete job;
+	}
+	for (auto& deferred : m_Deferred)
+	{
+		delete deferred.Pending;
+	}
+	if (t_Owner == this)
+	{
+		t_Owner = nullptr;
+		t_Slot = NoSlot;
+	}
+}
+
+void JobSystem::Submit(std::function<void()> job, JobCounter* counter)
+{
+	if (counter)
+	{
+		counter->Pending.fetch_add(1, std::memory_order_relaxed);
+	}
+	Enqueue(new Job{ std::move(job), counter });
+}
+
+void JobSystem::Submit(std::function<void()> job, JobCounter& dependency, JobCounter* counter)
+{
+	if (counter)
+	{
+		counter->Pending.fetch_add(1, std::memory_order_relaxed);
+	}
+	Job* pending = new Job{ std::move(job), counter };
+	{
+		std::lock_guard<std::mutex> lock(m_DeferredMutex);
+		//park it first and check after, so either this sees zero or the last job of dependency sees it parked
+		m_Deferred.push_back({ pending, &dependency });
+		m_DeferredCount.fetch_add(1);
+		if (dependency.Pending.load() > 0)
+		{
+			return;
+		}
+		m_Deferred.pop_back();
+		m_DeferredCount.fetch_sub(1);
+	}
+	Enqueue(pending);
+}
+
+void JobSystem::SubmitMain(std::function<void()> job, JobCounter* counter)
+{
+	if (counter)
+	{
+		counter->Pending.fetch_add(1, std::memory_order_relaxed);
+	}
+	std::lock_guard<std::mutex> lock(m_MainMutex);
+	m_MainJobs.push_back(new Job{ std::move(job), counter });
+}
+
+void JobSystem::Enqueue(Job* job)
+{
+	if (t_Owner == this)
+	{
+		ThreadState& thread = *m_Threads[t_Slot];
+		if (!thread.Queue.Push(job))
+		{
+			thread.RunInline.fetch_add(1, std::memory_order_relaxed);
+			Execute(job, t_Slot);
+			return;
+		}
+	}
+	else
+	{
+		std::lock_guard<std::mutex> lock(m_InjectedMutex);
+		m_Injected.push_back(job);
+	}
+	m_Queued.fetch_add(1);
+	WakeWorker();
+}
+
+void JobSystem::WakeWorker()
+{
+	if (m_Sleeping.load() > 0)
+	{
+		//taking the lock orders the notify after a worker's check of m_Queued
+		{
+			std::lock_guard<std::mutex> lock(m_SleepMutex);
+		}
+		m_Condition.notify_one();
+	}
+}
+
+JobSystem::Job* JobSystem::TakeInjected()
+{
+	std::lock_guard<std::mutex> lock(m_InjectedMutex);
+	if (m_Injected.empty())
+	{
+		return nullptr;
+	}
+	Job* job = m_Injected.front();
+	m_Injected.pop_front();
+	return job;
+}
+
+JobSystem::Job* JobSystem::FindJob(uint32_t threadIndex)
+{
+	if (threadIndex != NoSlot)
+	{
+		if (Job* job = m_Threads[threadIndex]->Queue.Pop())
+		{
+			return job;
+		}
+	}
+	if (Job* job = TakeInjected())
+	{
+		return job;
+	}
+	uint32_t threadCount = static_cast<uint32_t>(m_Threads.size());
+	uint32_t start = NextRandom() % threadCount;
+	for (uint32_t i = 0; i < threadCount; i++)
+	{
+		uint32_t victim = (start + i) % threadCount;
+		if (victim == threadIndex)
+		{
+			continue;
+		}
+		if (Job* job = m_Threads[victim]->Queue.Steal())
+		{
+			if (threadIndex != NoSlot)
+			{
+				m_Threads[threadIndex]->Stolen.fetch_add(1, std::memory_order_relaxed);
+			}
+			return job;
+		}
+	}
+	return nullptr;
+}
+
+bool JobSystem::RunPending()
+{
+	uint32_t slot = t_Owner == this ? t_Slot : NoSlot;
+	Job* job = FindJob(slot);
+	if (!job)
+	{
+		return false;
+	}
+	m_Queued.fetch_sub(1);
+	Execute(job, slot);
+	return true;
+}
+
+bool JobSystem::HasMainJobs()
+{
+	std::lock_guard<std::mutex> lock(m_MainMutex);
+	return !m_MainJobs.empty();
+}
+
+void JobSystem::CallMain(const std::function<void()>& job)
+{
+	if (IsMainThread())
+	{
+		job();
+		return;
+	}
+	JobCounter counter;
+	SubmitMain(job, &counter);
+	Wait(counter);
+}
+
+void JobSystem::RunMainThreadJobs()
+{
+	if (!IsMainThread())
+	{
+		return;
+	}
+	std::deque<Job*> jobs;
+	{
+		std::lock_guard<std::mutex> lock(m_MainMutex);
+		jobs.swap(m_MainJobs);
+	}
+	for (auto job : jobs)
+	{
+		Execute(job, t_Owner == this ? t_Slot : NoSlot);
+	}
+}
+
+void JobSystem::Wait(JobCounter& counter)
+{
+	bool mainThread = IsMainThread();
+	while (counter.Pending.load(std::memory_order_acquire) > 0)
+	{
+		//a worker may be waiting on something only the main thread can run
+		if (mainThread)
+		{
+			RunMainThreadJobs();
+		}
+		if (!RunPending())
+		{
+			std::this_thread::yield();
+		}
+	}
+	std::exception_ptr error;
+	{
+		std::lock_guard<std::mutex> lock(counter.ErrorMutex);
+		error = std::exchange(counter.Error, nullptr);
+	}
+	if (error)
+	{
+		std::rethrow_exception(error);
+	}
+}
+
+void JobSystem::ParallelFor(uint32_t count, uint32_t grainSize, const std::function<void(uint32_t first, uint32_t last)>& body)
+{
+	if (count == 0)
+	{
+		return;
+	}
+	if (grainSize == 0)
+	{
+		uint32_t threadCount = static_cast<uint32_t>(m_Threads.size());
+		grainSize = (std::max)(1u, count / (threadCount * 4));
+	}
+	uint32_t chunkCount = (count + grainSize - 1) / grainSize;
+	JobCounter counter;
+	for (uint32_t chunk = 1; chunk < chunkCount; chunk++)
+	{
+		Submit([&body, chunk, grainSize, count]() {
+			body(chunk * grainSize, (std::min)(count, (chunk + 1) * grainSize));
+		}, &counter);
+	}
+	//the caller takes the first range instead of idling until Wait
+	try
+	{
+		body(0, (std::min)(count, grainSize));
+	}
+	catch (...)
+	{
+		//the queued ranges still reference body, let them finish before unwinding; the first range's error wins
+		try
+		{
+			Wait(counter);
+		}
+		catch (...)
+		{
+		}
+		throw;
+	}
+	Wait(counter);
+}
+
+void JobSystem::WorkerLoop(uint32_t threadIndex)
+{
+	t_ThreadIndex = threadIndex;
+	t_Owner = this;
+	t_Slot = threadIndex;
+	t_Seed = 0x9E3779B9u * (threadIndex + 1);
+	uint32_t idle = 0;
+	while (!m_Stop.load(std::memory_order_relaxed))
+	{
+		if (Job* job = FindJob(threadIndex))
+		{
+			m_Queued.fetch_sub(1);
+			Execute(job, threadIndex);
+			idle = 0;
+			continue;
+		}
+		if (++idle < IdleSpins)
+		{
+			std::this_thread::yield();
+			continue;
+		}
+		m_Sleeping.fetch_add(1);
+		{
+			std::unique_lock<std::mutex> lock(m_SleepMutex);
+			m_Condition.wait(lock, [this]() { return m_Stop.load() || m_Queued.load() > 0; });
+		}
+		m_Sleeping.fetch_sub(1);
+		idle = 0;
+	}
+}
+
+void JobSystem::Execute(Job* job, uint32_t threadIndex)
+{
+	std::exception_ptr error;
+	try
+	{
+		job->Function();
+	}
+	catch (...)
+	{
+		error = std::current_exception();
+	}
+	JobCounter* counter = job->Counter;
+	delete job;
+	m_Threads[threadIndex == NoSlot ? 0 : threadIndex]->Executed.fetch_add(1, std::memory_order_relaxed);
+	if (!counter)
+	{
+		//nobody waits on it, so there is nowhere else to report to
+		if (error)
+		{
+			std::rethrow_exception(error);
+		}
+		return;
+	}
+	if (error)
+	{
+		std::lock_guard<std::mutex> lock(counter->ErrorMutex);
+		if (!counter->Error)
+		{
+			counter->Error = error;
+		}
+	}
+	if (counter->Pending.fetch_sub(1) == 1 && m_DeferredCount.load() > 0)
+	{
+		ReleaseDeferred();
+	}
+}
+
+void JobSystem::ReleaseDeferred()
+{
+	std::vector<Job*> ready;
+	{
+		std::lock_guard<std::mutex> lock(m_DeferredMutex);
+		//counters can be raised again, so go by the count rather than which counter just finished
+		auto end = std::remove_if(m_Deferred.begin(), m_Deferred.end(), [&](const DeferredJob& deferred) {
+			if (deferred.Dependency->Pending.load() > 0)
+			{
+				return false;
+			}
+			ready.push_back(deferred.Pending);
+			return true;
+		});
+		m_Deferred.erase(end, m_Deferred.end());
+		m_DeferredCount.fetch_sub(static_cast<uint32_t>(ready.size()));
+	}
+	for (auto job : ready)
+	{
+		Enqueue(job);
+	}
+}
+
+JobSystemStats JobSystem::GetStats() const
+{
+	JobSystemStats stats;
+	for (auto& thread : m_Threads)
+	{
+		stats.Executed += thread->Executed.load(std::memory_order_relaxed);
+		stats.Stolen += thread->Stolen.load(std::memory_order_relaxed);
+		stats.RunInline += thread->RunInline.load(std::memory_order_relaxed);
+	}
+	return stats;
+}
+
+uint32_t JobSystem::GetThreadIndex()
+{
+	return t_ThreadIndex;
+}
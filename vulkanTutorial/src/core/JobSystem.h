@@ -0,0 +1,120 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+//number of unfinished jobs submitted against it
+struct JobCounter
+{
+	std::atomic<uint32_t> Pending{ 0 };
+	//first exception thrown by one of its jobs, rethrown by Wait
+	std::exception_ptr Error;
+	std::mutex ErrorMutex;
+};
+
+struct JobSystemStats
+{
+	uint64_t Executed = 0;
+	uint64_t Stolen = 0;
+	//a full deque runs the job on the submitting thread
+	uint64_t RunInline = 0;
+};
+
+//fixed pool of worker threads, each with its own work-stealing deque; idle threads steal from the others
+//the thread that creates the system is the main thread, jobs submitted with SubmitMain only run there
+class JobSystem
+{
+public:
+	static JobSystem& Get();
+	explicit JobSystem(uint32_t threadCount = 0);
+	//stops the workers, then runs whatever is still queued on the destroying thread
+	~JobSystem();
+	JobSystem(const JobSystem&) = delete;
+	JobSystem& operator=(const JobSystem&) = delete;
+	void Submit(std::function<void()> job, JobCounter* counter = nullptr);
+	//queued once dependency drops to zero, counter is raised right away so waiting on it covers the deferred job
+	void Submit(std::function<void()> job, JobCounter& dependency, JobCounter* counter = nullptr);
+	//for calls that must stay on the main thread, e.g. glfw; run by RunMainThreadJobs or a Wait on the main thread
+	void SubmitMain(std::function<void()> job, JobCounter* counter = nullptr);
+	//SubmitMain that returns once the job has run, on the main thread it runs right away
+	void CallMain(const std::function<void()>& job);
+	//splits [0, count) into ranges of grainSize, 0 picks a few ranges per thread, returns when all have run
+	void ParallelFor(uint32_t count, uint32_t grainSize, const std::function<void(uint32_t first, uint32_t last)>& body);
+	//runs one queued job on the calling thread, false if there was nothing to run
+	bool RunPending();
+	void RunMainThreadJobs();
+	//helps with queued work until the counter drops to zero, then rethrows the first exception of its jobs
+	void Wait(JobCounter& counter);
+	uint32_t GetWorkerCount() const { return static_cast<uint32_t>(m_Workers.size()); }
+	bool IsMainThread() const { return std::this_thread::get_id() == m_MainThread; }
+	JobSystemStats GetStats() const;
+	//1..workerCount on the workers, 0 on every other thread, for per-thread resources like command pools
+	static uint32_t GetThreadIndex();
+private:
+	struct Job
+	{
+		std::function<void()> Function;
+		JobCounter* Counter;
+	};
+	//Chase-Lev deque: the owner pushes and pops at the bottom, thieves take from the top
+	class WorkQueue
+	{
+	public:
+		explicit WorkQueue(uint32_t capacity);
+		bool Push(Job* job);
+		Job* Pop();
+		Job* Steal();
+	private:
+		std::unique_ptr<std::atomic<Job*>[]> m_Buffer;
+		int64_t m_Mask;
+		alignas(64) std::atomic<int64_t> m_Top{ 0 };
+		alignas(64) std::atomic<int64_t> m_Bottom{ 0 };
+	};
+	struct alignas(64) ThreadState
+	{
+		ThreadState() : Queue(4096) {}
+		WorkQueue Queue;
+		std::atomic<uint64_t> Executed{ 0 };
+		std::atomic<uint64_t> Stolen{ 0 };
+		std::atomic<uint64_t> RunInline{ 0 };
+	};
+	struct DeferredJob
+	{
+		Job* Pending;
+		JobCounter* Dependency;
+	};
+	void WorkerLoop(uint32_t threadIndex);
+	void Enqueue(Job* job);
+	Job* FindJob(uint32_t threadIndex);
+	Job* TakeInjected();
+	void Execute(Job* job, uint32_t threadIndex);
+	void ReleaseDeferred();
+	bool HasMainJobs();
+	void WakeWorker();
+private:
+	std::thread::id m_MainThread;
+	std::vector<std::thread> m_Workers;
+	//slot 0 belongs to the main thread, the others to the workers
+	std::vector<std::unique_ptr<ThreadState>> m_Threads;
+	//jobs submitted from threads without a deque of their own
+	std::deque<Job*> m_Injected;
+	std::mutex m_InjectedMutex;
+	std::deque<Job*> m_MainJobs;
+	std::mutex m_MainMutex;
+	std::vector<DeferredJob> m_Deferred;
+	std::mutex m_DeferredMutex;
+	std::atomic<uint32_t> m_DeferredCount{ 0 };
+	//queued and not yet taken, idle workers sleep while it is zero
+	std::atomic<int64_t> m_Queued{ 0 };
+	std::atomic<uint32_t> m_Sleeping{ 0 };
+	std::mutex m_SleepMutex;
+	std::condition_variable m_Condition;
+	std::atomic<bool> m_Stop{ false };
+};
@@ -0,0 +1,104 @@
+#include "MappedFile.h"
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::~MappedFile()
+{
+	Close();
+}
+
+#ifdef _WIN32
+bool MappedFile::Open(const std::string& path)
+{
+	Close();
+	HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+	{
+		return false;
+	}
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+	{
+		CloseHandle(file);
+		return false;
+	}
+	HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (!mapping)
+	{
+		CloseHandle(file);
+		return false;
+	}
+	void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	if (!data)
+	{
+		CloseHandle(mapping);
+		CloseHandle(file);
+		return false;
+	}
+	m_File = file;
+	m_Mapping = mapping;
+	m_Data = static_cast<const uint8_t*>(data);
+	m_Size = static_cast<size_t>(size.QuadPart);
+	return true;
+}
+
+void MappedFile::Close()
+{
+	if (m_Data)
+	{
+		UnmapViewOfFile(m_Data);
+		CloseHandle(m_Mapping);
+		CloseHandle(m_File);
+	}
+	m_Data = nullptr;
+	m_Size = 0;
+	m_File = nullptr;
+	m_Mapping = nullptr;
+}
+#else
+bool MappedFile::Open(const std::string& path)
+{
+	Close();
+	int file = open(path.c_str(), O_RDONLY);
+	if (file < 0)
+	{
+		return false;
+	}
+	struct stat info;
+	if (fstat(file, &info) != 0 || info.st_size == 0)
+	{
+		close(file);
+		return false;
+	}
+	void* data = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+	if (data == MAP_FAILED)
+	{
+		close(file);
+		return false;
+	}
+	m_File = file;
+	m_Data = static_cast<const uint8_t*>(data);
+	m_Size = static_cast<size_t>(info.st_size);
+	return true;
+}
+
+void MappedFile::Close()
+{
+	if (m_Data)
+	{
+		munmap(const_cast<uint8_t*>(m_Data), m_Size);
+		close(m_File);
+	}
+	m_Data = nullptr;
+	m_Size = 0;
+	m_File = -1;
+}
+#endif
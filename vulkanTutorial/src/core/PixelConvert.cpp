@@ -0,0 +1,76 @@
+#include "PixelConvert.h"
+
+#if defined(_M_X64) || defined(__x86_64__)
+#define PIXEL_CONVERT_SSSE3
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define SSSE3_TARGET
+#else
+#define SSSE3_TARGET __attribute__((target("ssse3")))
+#endif
+#endif
+
+static void ExpandRGBToRGBAScalar(const uint8_t* rgb, uint8_t* rgba, size_t pixelCount)
+{
+	for (size_t i = 0; i < pixelCount; i++)
+	{
+		rgba[0] = rgb[0];
+		rgba[1] = rgb[1];
+		rgba[2] = rgb[2];
+		rgba[3] = 0xFF;
+		rgb += 3;
+		rgba += 4;
+	}
+}
+
+#ifdef PIXEL_CONVERT_SSSE3
+static bool HasSSSE3()
+{
+#ifdef _MSC_VER
+	int info[4];
+	__cpuid(info, 1);
+	return (info[2] & (1 << 9)) != 0;
+#else
+	return __builtin_cpu_supports("ssse3");
+#endif
+}
+
+//16 pixels per iteration: three 16 byte loads realigned so each shuffle sees 4 whole pixels
+SSSE3_TARGET static size_t ExpandRGBToRGBASSSE3(const uint8_t* rgb, uint8_t* rgba, size_t pixelCount)
+{
+	const __m128i shuffle = _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+	const __m128i alpha = _mm_set1_epi32(static_cast<int>(0xFF000000));
+	size_t i = 0;
+	for (; i + 16 <= pixelCount; i += 16)
+	{
+		__m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rgb));
+		__m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rgb + 16));
+		__m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rgb + 32));
+		__m128i p0 = _mm_shuffle_epi8(a, shuffle);
+		__m128i p1 = _mm_shuffle_epi8(_mm_alignr_epi8(b, a, 12), shuffle);
+		__m128i p2 = _mm_shuffle_epi8(_mm_alignr_epi8(c, b, 8), shuffle);
+		__m128i p3 = _mm_shuffle_epi8(_mm_srli_si128(c, 4), shuffle);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(rgba), _mm_or_si128(p0, alpha));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(rgba + 16), _mm_or_si128(p1, alpha));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(rgba + 32), _mm_or_si128(p2, alpha));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(rgba + 48), _mm_or_si128(p3, alpha));
+		rgb += 48;
+		rgba += 64;
+	}
+	return i;
+}
+#endif
+
+void ExpandRGBToRGBA(const uint8_t* rgb, uint8_t* rgba, size_t pixelCount)
+{
+	size_t done = 0;
+#ifdef PIXEL_CONVERT_SSSE3
+	static const bool s_HasSSSE3 = HasSSSE3();
+	if (s_HasSSSE3)
+	{
+		done = ExpandRGBToRGBASSSE3(rgb, rgba, pixelCount);
+	}
+#endif
+	ExpandRGBToRGBAScalar(rgb + done * 3, rgba + done * 4, pixelCount - done);
+}
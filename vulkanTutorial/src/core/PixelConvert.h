@@ -0,0 +1,6 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+//tightly packed 8 bit rgb to rgba with opaque alpha
+void ExpandRGBToRGBA(const uint8_t* rgb, uint8_t* rgba, size_t pixelCount);
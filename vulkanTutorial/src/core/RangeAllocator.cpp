@@ -0,0 +1,108 @@
+#include "RangeAllocator.h"
+#include <iterator>
+
+static uint64_t AlignUp(uint64_t value, uint64_t alignment)
+{
+	return (value + alignment - 1) / alignment * alignment;
+}
+
+void RangeAllocator::Create(uint64_t size)
+{
+	m_Size = size;
+	m_FreeBytes = 0;
+	m_FreeByOffset.clear();
+	m_FreeBySize.clear();
+	if (size > 0)
+	{
+		InsertFreeRange(0, size);
+	}
+}
+
+bool RangeAllocator::Allocate(uint64_t size, uint64_t alignment, uint64_t* offset)
+{
+	alignment = alignment > 0 ? alignment : 1;
+	//best fit: smallest free range that still holds the aligned request
+	for (auto it = m_FreeBySize.lower_bound(size); it != m_FreeBySize.end(); ++it)
+	{
+		uint64_t rangeOffset = it->second;
+		uint64_t rangeSize = it->first;
+		uint64_t alignedOffset = AlignUp(rangeOffset, alignment);
+		uint64_t padding = alignedOffset - rangeOffset;
+		if (padding + size > rangeSize)
+		{
+			continue;
+		}
+		EraseFreeRange(m_FreeByOffset.find(rangeOffset));
+		//the padding in front stays free
+		if (padding > 0)
+		{
+			InsertFreeRange(rangeOffset, padding);
+		}
+		if (rangeSize > padding + size)
+		{
+			InsertFreeRange(alignedOffset + size, rangeSize - padding - size);
+		}
+		*offset = alignedOffset;
+		return true;
+	}
+	return false;
+}
+
+void RangeAllocator::Free(uint64_t offset, uint64_t size)
+{
+	InsertFreeRange(offset, size);
+}
+
+uint64_t RangeAllocator::GetLargestFreeRange() const
+{
+	return m_FreeBySize.empty() ? 0 : std::prev(m_FreeBySize.end())->first;
+}
+
+float RangeAllocator::GetFragmentation() const
+{
+	if (m_FreeBytes == 0)
+	{
+		return 0.0f;
+	}
+	return 1.0f - static_cast<float>(GetLargestFreeRange()) / static_cast<float>(m_FreeBytes);
+}
+
+void RangeAllocator::InsertFreeRange(uint64_t offset, uint64_t size)
+{
+	//coalesce with the neighbouring free ranges
+	auto next = m_FreeByOffset.lower_bound(offset);
+	if (next != m_FreeByOffset.begin())
+	{
+		auto prev = std::prev(next);
+		if (prev->first + prev->second == offset)
+		{
+			offset = prev->first;
+			size += prev->second;
+			EraseFreeRange(prev);
+		}
+	}
+	next = m_FreeByOffset.lower_bound(offset);
+	if (next != m_FreeByOffset.end() && offset + size == next->first)
+	{
+		size += next->second;
+		EraseFreeRange(next);
+	}
+	m_FreeByOffset.emplace(offset, size);
+	m_FreeBySize.emplace(size, offset);
+	m_FreeBytes += size;
+}
+
+void RangeAllocator::EraseFreeRange(std::map<uint64_t, uint64_t>::iterator range)
+{
+	auto sizeRange = m_FreeBySize.equal_range(range->second);
+	for (auto it = sizeRange.first; it != sizeRange.second; ++it)
+	{
+		if (it->second == range->first)
+		{
+			m_FreeBySize.erase(it);
+			break;
+		}
+	}
+	m_FreeBytes -= range->second;
+	m_FreeByOffset.erase(range);
+}
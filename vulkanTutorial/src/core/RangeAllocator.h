@@ -0,0 +1,29 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <map>
+
+//free range bookkeeping of one memory block: best fit allocation with alignment, coalescing free
+class RangeAllocator
+{
+public:
+	void Create(uint64_t size);
+	//false when no free range holds the aligned request, offset is only written on success
+	bool Allocate(uint64_t size, uint64_t alignment, uint64_t* offset);
+	//size must be the size passed to Allocate
+	void Free(uint64_t offset, uint64_t size);
+	uint64_t GetSize() const { return m_Size; }
+	uint64_t GetFreeBytes() const { return m_FreeBytes; }
+	uint64_t GetLargestFreeRange() const;
+	size_t GetFreeRangeCount() const { return m_FreeByOffset.size(); }
+	//1 - largest free range / free bytes, 0 when the free space is contiguous
+	float GetFragmentation() const;
+private:
+	void InsertFreeRange(uint64_t offset, uint64_t size);
+	void EraseFreeRange(std::map<uint64_t, uint64_t>::iterator range);
+private:
+	uint64_t m_Size = 0;
+	uint64_t m_FreeBytes = 0;
+	std::map<uint64_t, uint64_t> m_FreeByOffset;
+	std::multimap<uint64_t, uint64_t> m_FreeBySize;
+};
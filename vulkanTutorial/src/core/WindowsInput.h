@@ -1,28 +1,32 @@
 #pragma once
 #include "KeyCode.h"
 #include "MouseCode.h"
+#include "JobSystem.h"
 #include "../AppBase.h"
 #include <GLFW/glfw3.h>
 #include <utility>
 
 
+//glfw input may only be queried on the main thread, calls from a job are handed over to it
 class WindowsInput
 {
 public:
 	inline static bool IsKeyPressed(KeyCode key) 
 	{
-		int state = glfwGetKey(static_cast<GLFWwindow*>(AppBase::Get().GetWindow().GetNativeWindow()), key);
+		int state = GLFW_RELEASE;
+		JobSystem::Get().CallMain([&]() { state = glfwGetKey(static_cast<GLFWwindow*>(AppBase::Get().GetWindow().GetNativeWindow()), key); });
 		return state == GLFW_PRESS || state == GLFW_REPEAT;
 	};
 	inline static bool IsMousePressed(MouseCode button) 
 	{ 
-		int state = glfwGetMouseButton(static_cast<GLFWwindow*>(AppBase::Get().GetWindow().GetNativeWindow()), button);
+		int state = GLFW_RELEASE;
+		JobSystem::Get().CallMain([&]() { state = glfwGetMouseButton(static_cast<GLFWwindow*>(AppBase::Get().GetWindow().GetNativeWindow()), button); });
 		return state == GLFW_PRESS || state == GLFW_REPEAT;
 	};
 	inline static std::pair<float, float> GetMousePos() 
 	{
-		double x, y;
-		glfwGetCursorPos(static_cast<GLFWwindow*>(AppBase::Get().GetWindow().GetNativeWindow()), &x, &y);
+		double x = 0.0, y = 0.0;
+		JobSystem::Get().CallMain([&]() { glfwGetCursorPos(static_cast<GLFWwindow*>(AppBase::Get().GetWindow().GetNativeWindow()), &x, &y); });
 		return std::make_pair(float(x), float(y));
 	};
 	inline static float GetMouseX() 
@@ -0,0 +1,352 @@
+#include "JobSystem.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+
+static int s_Failures = 0;
+
+#define CHECK(condition) \
+	do \
+	{ \
+		if (!(condition)) \
+		{ \
+			std::printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition); \
+			s_Failures++; \
+		} \
+	} while (0)
+
+//every job runs exactly once while the main thread pushes and pops its deque and the workers steal from it
+static void TestPushPopSteal()
+{
+	JobSystem jobs(4);
+	for (uint32_t round = 0; round < 20; round++)
+	{
+		const uint32_t jobCount = 2000;
+		std::unique_ptr<std::atomic<uint32_t>[]> runs(new std::atomic<uint32_t>[jobCount]);
+		for (uint32_t i = 0; i < jobCount; i++)
+		{
+			runs[i] = 0;
+		}
+		JobCounter counter;
+		for (uint32_t i = 0; i < jobCount; i++)
+		{
+			jobs.Submit([&runs, i]() {
+				//some jobs take a while so the workers get to steal
+				if (i % 64 == 0)
+				{
+					std::this_thread::sleep_for(std::chrono::microseconds(50));
+				}
+				runs[i]++;
+			}, &counter);
+		}
+		jobs.Wait(counter);
+		for (uint32_t i = 0; i < jobCount; i++)
+		{
+			CHECK(runs[i] == 1);
+		}
+	}
+	CHECK(jobs.GetStats().Stolen > 0);
+}
+
+//jobs submitted from inside jobs go to the worker's own deque, nested waits keep helping
+static void TestNestedSubmit()
+{
+	JobSystem jobs(3);
+	std::atomic<uint32_t> leaves{ 0 };
+	JobCounter outer;
+	for (uint32_t i = 0; i < 64; i++)
+	{
+		jobs.Submit([&]() {
+			JobCounter inner;
+			for (uint32_t j = 0; j < 64; j++)
+			{
+				jobs.Submit([&]() { leaves++; }, &inner);
+			}
+			jobs.Wait(inner);
+		}, &outer);
+	}
+	jobs.Wait(outer);
+	CHECK(leaves == 64 * 64);
+}
+
+//with the only worker blocked the main thread's deque fills up, further jobs run inline on submit
+static void TestOverflowRunsInline()
+{
+	JobSystem jobs(1);
+	std::atomic<bool> started{ false };
+	std::atomic<bool> gate{ false };
+	JobCounter counter;
+	jobs.Submit([&]() {
+		started = true;
+		while (!gate)
+		{
+			std::this_thread::yield();
+		}
+	}, &counter);
+	while (!started)
+	{
+		std::this_thread::yield();
+	}
+	const uint32_t jobCount = 4096 + 100;
+	std::atomic<uint32_t> runs{ 0 };
+	for (uint32_t i = 0; i < jobCount; i++)
+	{
+		jobs.Submit([&]() { runs++; }, &counter);
+	}
+	CHECK(jobs.GetStats().RunInline >= 100);
+	CHECK(runs >= 100);
+	gate = true;
+	jobs.Wait(counter);
+	CHECK(runs == jobCount);
+}
+
+//a job submitted against a dependency only starts once every job of the dependency has finished
+static void TestDependencyChain()
+{
+	JobSystem jobs(4);
+	for (uint32_t round = 0; round < 50; round++)
+	{
+		JobCounter first;
+		JobCounter second;
+		JobCounter third;
+		std::atomic<uint32_t> firstDone{ 0 };
+		std::atomic<uint32_t> secondDone{ 0 };
+		std::atomic<bool> ordered{ true };
+		for (uint32_t i = 0; i < 16; i++)
+		{
+			jobs.Submit([&]() {
+				std::this_thread::sleep_for(std::chrono::microseconds(50));
+				firstDone++;
+			}, &first);
+		}
+		for (uint32_t i = 0; i < 8; i++)
+		{
+			jobs.Submit([&]() {
+				if (firstDone != 16)
+				{
+					ordered = false;
+				}
+				secondDone++;
+			}, first, &second);
+		}
+		jobs.Submit([&]() {
+			if (secondDone != 8)
+			{
+				ordered = false;
+			}
+		}, second, &third);
+		jobs.Wait(third);
+		CHECK(ordered);
+		CHECK(secondDone == 8);
+	}
+
+	//a finished dependency queues the job right away
+	JobCounter done;
+	JobCounter counter;
+	std::atomic<bool> ran{ false };
+	jobs.Submit([&]() { ran = true; }, done, &counter);
+	jobs.Wait(counter);
+	CHECK(ran);
+}
+
+//every index is covered exactly once for any grain size, including ranges shorter than a grain
+static void TestParallelForCoverage()
+{
+	JobSystem jobs(4);
+	const uint32_t counts[] = { 1, 7, 64, 1000, 100003 };
+	const uint32_t grains[] = { 0, 1, 7, 4096, 200000 };
+	for (uint32_t count : counts)
+	{
+		for (uint32_t grain : grains)
+		{
+			std::unique_ptr<std::atomic<uint32_t>[]> hits(new std::atomic<uint32_t>[count]);
+			for (uint32_t i = 0; i < count; i++)
+			{
+				hits[i] = 0;
+			}
+			std::atomic<bool> inRange{ true };
+			jobs.ParallelFor(count, grain, [&](uint32_t first, uint32_t last) {
+				if (first >= last || last > count)
+				{
+					inRange = false;
+					return;
+				}
+				for (uint32_t i = first; i < last; i++)
+				{
+					hits[i]++;
+				}
+			});
+			CHECK(inRange);
+			uint32_t wrong = 0;
+			for (uint32_t i = 0; i < count; i++)
+			{
+				wrong += hits[i] != 1;
+			}
+			CHECK(wrong == 0);
+		}
+	}
+	jobs.ParallelFor(0, 0, [&](uint32_t, uint32_t) { CHECK(false); });
+}
+
+//a throw from the caller's own range only propagates once the queued ranges are done with body
+static void TestParallelForThrow()
+{
+	JobSystem jobs(2);
+	const uint32_t chunkCount = 32;
+	std::atomic<uint32_t> finished{ 0 };
+	bool caught = false;
+	try
+	{
+		jobs.ParallelFor(chunkCount, 1, [&](uint32_t first, uint32_t) {
+			if (first == 0)
+			{
+				throw std::runtime_error("first range");
+			}
+			std::this_thread::sleep_for(std::chrono::microseconds(200));
+			finished++;
+		});
+	}
+	catch (const std::runtime_error&)
+	{
+		caught = true;
+		CHECK(finished == chunkCount - 1);
+	}
+	CHECK(caught);
+}
+
+//a throwing job still finishes its counter, Wait rethrows the error on the waiting thread once
+static void TestJobExceptions()
+{
+	JobSystem jobs(3);
+	JobCounter counter;
+	std::atomic<uint32_t> runs{ 0 };
+	for (uint32_t i = 0; i < 100; i++)
+	{
+		jobs.Submit([&, i]() {
+			runs++;
+			if (i % 10 == 0)
+			{
+				throw std::runtime_error("job failed");
+			}
+		}, &counter);
+	}
+	bool caught = false;
+	try
+	{
+		jobs.Wait(counter);
+	}
+	catch (const std::runtime_error&)
+	{
+		caught = true;
+	}
+	CHECK(caught);
+	CHECK(runs == 100);
+	CHECK(counter.Pending == 0);
+	//the error was handed out, the counter can be reused
+	jobs.Submit([]() {}, &counter);
+	jobs.Wait(counter);
+
+	caught = false;
+	try
+	{
+		jobs.ParallelFor(64, 1, [](uint32_t first, uint32_t) {
+			if (first == 63)
+			{
+				throw std::runtime_error("range failed");
+			}
+		});
+	}
+	catch (const std::runtime_error&)
+	{
+		caught = true;
+	}
+	CHECK(caught);
+}
+
+//main thread jobs never run on a worker, a worker blocked in CallMain resumes once the main thread pumps them
+static void TestSubmitMain()
+{
+	JobSystem jobs(3);
+	std::thread::id mainThread = std::this_thread::get_id();
+	std::atomic<uint32_t> onMain{ 0 };
+	std::atomic<uint32_t> offMain{ 0 };
+	JobCounter counter;
+	for (uint32_t i = 0; i < 32; i++)
+	{
+		jobs.Submit([&]() {
+			jobs.SubmitMain([&]() {
+				(std::this_thread::get_id() == mainThread ? onMain : offMain)++;
+			}, &counter);
+		}, &counter);
+	}
+	//Wait on the main thread runs main thread jobs as well
+	jobs.Wait(counter);
+	CHECK(onMain == 32);
+	CHECK(offMain == 0);
+
+	std::atomic<bool> ran{ false };
+	jobs.SubmitMain([&]() { ran = true; });
+	std::this_thread::sleep_for(std::chrono::milliseconds(10));
+	CHECK(!ran);
+	jobs.RunMainThreadJobs();
+	CHECK(ran);
+
+	std::atomic<bool> called{ false };
+	JobCounter worker;
+	jobs.Submit([&]() {
+		jobs.CallMain([&]() { called = std::this_thread::get_id() == mainThread; });
+	}, &worker);
+	jobs.Wait(worker);
+	CHECK(called);
+}
+
+//jobs still queued when the system goes away are run rather than dropped, deferred ones included
+static void TestDestructorDrains()
+{
+	std::atomic<uint32_t> runs{ 0 };
+	std::atomic<uint32_t> deferredRuns{ 0 };
+	std::atomic<uint32_t> mainRuns{ 0 };
+	//outlives the system, the deferred jobs check it until they are released
+	JobCounter counter;
+	{
+		JobSystem jobs(2);
+		for (uint32_t i = 0; i < 1000; i++)
+		{
+			jobs.Submit([&]() {
+				std::this_thread::sleep_for(std::chrono::microseconds(10));
+				runs++;
+			}, &counter);
+		}
+		for (uint32_t i = 0; i < 10; i++)
+		{
+			jobs.Submit([&]() { deferredRuns++; }, counter);
+		}
+		jobs.SubmitMain([&]() { mainRuns++; });
+	}
+	CHECK(runs == 1000);
+	CHECK(deferredRuns == 10);
+	CHECK(mainRuns == 1);
+}
+
+int main()
+{
+	TestPushPopSteal();
+	TestNestedSubmit();
+	TestOverflowRunsInline();
+	TestDependencyChain();
+	TestParallelForCoverage();
+	TestParallelForThrow();
+	TestJobExceptions();
+	TestSubmitMain();
+	TestDestructorDrains();
+	if (s_Failures > 0)
+	{
+		std::printf("%d checks failed\n", s_Failures);
+		return 1;
+	}
+	std::printf("all job system tests passed\n");
+	return 0;
+}
@@ -0,0 +1,130 @@
+#include "RangeAllocator.h"
+#include <cstdio>
+
+static int s_Failures = 0;
+
+#define CHECK(condition) \
+	do \
+	{ \
+		if (!(condition)) \
+		{ \
+			std::printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition); \
+			s_Failures++; \
+		} \
+	} while (0)
+
+//allocations are carved from the front, freeing the middle one last merges it with both free neighbours
+static void TestSplitAndCoalesce()
+{
+	RangeAllocator ranges;
+	ranges.Create(1024);
+	CHECK(ranges.GetFreeBytes() == 1024);
+	CHECK(ranges.GetFreeRangeCount() == 1);
+
+	uint64_t a = 0, b = 0, c = 0;
+	CHECK(ranges.Allocate(256, 1, &a));
+	CHECK(ranges.Allocate(256, 1, &b));
+	CHECK(ranges.Allocate(256, 1, &c));
+	CHECK(a == 0 && b == 256 && c == 512);
+	CHECK(ranges.GetFreeBytes() == 256);
+	CHECK(ranges.GetLargestFreeRange() == 256);
+
+	//a and the tail are free but apart
+	ranges.Free(a, 256);
+	ranges.Free(c, 256);
+	CHECK(ranges.GetFreeRangeCount() == 2);
+	CHECK(ranges.GetFreeBytes() == 768);
+	CHECK(ranges.GetLargestFreeRange() == 512);
+	CHECK(ranges.GetFragmentation() > 0.3f && ranges.GetFragmentation() < 0.4f);
+
+	ranges.Free(b, 256);
+	CHECK(ranges.GetFreeRangeCount() == 1);
+	CHECK(ranges.GetFreeBytes() == 1024);
+	CHECK(ranges.GetLargestFreeRange() == 1024);
+	CHECK(ranges.GetFragmentation() == 0.0f);
+
+	//the whole block is usable again
+	uint64_t all = 1;
+	CHECK(ranges.Allocate(1024, 1, &all));
+	CHECK(all == 0);
+	CHECK(ranges.GetFreeBytes() == 0);
+	CHECK(!ranges.Allocate(1, 1, &all));
+}
+
+//the smallest free range that holds the request wins, even when a larger one comes first
+static void TestBestFit()
+{
+	RangeAllocator ranges;
+	ranges.Create(1000);
+	uint64_t offsets[5];
+	const uint64_t sizes[5] = { 300, 100, 100, 100, 400 };
+	for (uint32_t i = 0; i < 5; i++)
+	{
+		CHECK(ranges.Allocate(sizes[i], 1, &offsets[i]));
+	}
+	//free holes of 300 at 0 and 100 at 400, with used ranges between them
+	ranges.Free(offsets[0], 300);
+	ranges.Free(offsets[2], 100);
+	CHECK(ranges.GetFreeRangeCount() == 2);
+
+	uint64_t offset = 0;
+	CHECK(ranges.Allocate(80, 1, &offset));
+	CHECK(offset == 400);
+	CHECK(ranges.Allocate(150, 1, &offset));
+	CHECK(offset == 0);
+	//nothing left is big enough
+	CHECK(!ranges.Allocate(200, 1, &offset));
+	CHECK(ranges.GetFreeBytes() == 20 + 150);
+}
+
+//the aligned offset skips ahead in the range, the skipped bytes stay free and are found again
+static void TestAlignmentPadding()
+{
+	RangeAllocator ranges;
+	ranges.Create(4096);
+	uint64_t first = 0;
+	CHECK(ranges.Allocate(10, 1, &first));
+	CHECK(first == 0);
+
+	uint64_t aligned = 0;
+	CHECK(ranges.Allocate(100, 256, &aligned));
+	CHECK(aligned == 256);
+	CHECK(ranges.GetFreeRangeCount() == 2);
+	CHECK(ranges.GetFreeBytes() == 4096 - 10 - 100);
+
+	//the padding between 10 and 256 takes a small request
+	uint64_t small = 0;
+	CHECK(ranges.Allocate(200, 8, &small));
+	CHECK(small == 16);
+
+	//a range big enough before padding but not after it is skipped
+	RangeAllocator tight;
+	tight.Create(300);
+	uint64_t head = 0;
+	CHECK(tight.Allocate(4, 1, &head));
+	uint64_t offset = 0;
+	CHECK(!tight.Allocate(250, 64, &offset));
+	CHECK(tight.Allocate(236, 64, &offset));
+	CHECK(offset == 64);
+
+	//freeing everything merges the padding back into one range
+	ranges.Free(first, 10);
+	ranges.Free(small, 200);
+	ranges.Free(aligned, 100);
+	CHECK(ranges.GetFreeRangeCount() == 1);
+	CHECK(ranges.GetLargestFreeRange() == 4096);
+}
+
+int main()
+{
+	TestSplitAndCoalesce();
+	TestBestFit();
+	TestAlignmentPadding();
+	if (s_Failures > 0)
+	{
+		std::printf("%d checks failed\n", s_Failures);
+		return 1;
+	}
+	std::printf("all range allocator tests passed\n");
+	return 0;
+}
@@ -0,0 +1,48 @@
+#include "Examples.h"
+#include "PBRModel.h"
+
+#include <functional>
+#include <map>
+
+using ExampleFactory = std::function<std::unique_ptr<AppBase>(int, int, const char*, bool)>;
+
+static const std::map<std::string, ExampleFactory>& GetFactories()
+{
+	static const std::map<std::string, ExampleFactory> factories = {
+		{ "PBRModel", [](int width, int height, const char* title, bool headless) { return std::make_unique<PBRModel>(width, height, title, headless); } },
+		//same scene on the dynamic rendering backend, to compare recording and rebuild cost
+		{ "PBRModelDynamic", [](int width, int height, const char* title, bool headless) {
+			auto app = std::make_unique<PBRModel>(width, height, title, headless);
+			app->SetDynamicRendering(true);
+			return app;
+		} },
+		//scene pass recorded into secondaries on the job system workers, against PBRModel's single threaded recording
+		{ "PBRModelParallel", [](int width, int height, const char* title, bool headless) {
+			auto app = std::make_unique<PBRModel>(width, height, title, headless);
+			app->SetParallelRecording(true);
+			return app;
+		} },
+	};
+	return factories;
+}
+
+std::vector<std::string> GetExampleNames()
+{
+	std::vector<std::string> names;
+	for (auto& [name, factory] : GetFactories())
+	{
+		names.push_back(name);
+	}
+	return names;
+}
+
+std::unique_ptr<AppBase> CreateExample(const std::string& name, int width, int height, bool headless)
+{
+	auto& factories = GetFactories();
+	auto it = factories.find(name);
+	if (it == factories.end())
+	{
+		return nullptr;
+	}
+	return it->second(width, height, name.c_str(), headless);
+}
@@ -0,0 +1,10 @@
+#pragma once
+#include "../AppBase.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+//examples compiled into this build, looked up by class name
+std::vector<std::string> GetExampleNames();
+std::unique_ptr<AppBase> CreateExample(const std::string& name, int width, int height, bool headless);
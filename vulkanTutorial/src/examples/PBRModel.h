@@ -9,7 +9,10 @@
 #include "../vulkan/CubeMap.h"
 #include "../vulkan/PipelineLayout.h"
 #include "../vulkan/RenderPass.h"
+#include "../vulkan/RenderGraph.h"
 #include "../vulkan/glTFModel.h"
+#include "../vulkan/FrameRing.h"
+#include "../vulkan/OffscreenTarget.h"
 #include "../AppBase.h"
 #include "../core/EditorCamera.h"
 
@@ -99,11 +102,26 @@ struct PipeLines
 class PBRModel : public AppBase
 {
 public:
-	PBRModel(int width, int height, const char* title) :AppBase(width, height, title) {}
+	PBRModel(int width, int height, const char* title, bool headless = false) :AppBase(width, height, title, headless) {}
+	void SetHeadlessOutput(uint32_t frameCount, const std::string& outputPath) { m_HeadlessFrames = frameCount; m_OutputPath = outputPath; }
+	void SetProfileOutput(const std::string& profilePath) { m_ProfilePath = profilePath; }
+	void SetIndirectDraw(bool indirect) { m_IndirectDraw = indirect; }
+	void SetBindless(bool bindless) { m_Model.SetBindless(bindless); }
+	//records the scene pass into secondaries on the job system workers
+	void SetParallelRecording(bool parallel) { m_ParallelRecording = parallel; }
+	//image count, vsync, low latency wait and frame rate cap, read in InitContext
+	void SetPresentPolicy(const PresentPolicy& policy) { m_PresentPolicy = policy; }
+	//vkCmdBeginRendering instead of render pass and framebuffer objects, when the device supports it
+	void SetDynamicRendering(bool dynamic) { m_DynamicRendering = dynamic; }
 	void Run();
-	void InitContext();
+	virtual void InitContext() override;
 	void RenderLoop();
-	void Clear();
+	virtual void RenderFrame() override;
+	virtual void WaitIdle() override;
+	virtual void Clear() override;
+	virtual void SetCameraPath(float t) override;
+	virtual Device* GetDevice() override { return &m_Device; }
+	virtual const CullStats* GetCullStats() override { return &m_Model.GetCullStats(); }
 	virtual void CreateSetLayout() override;
 	virtual void RebuildFrameBuffer() override;
 private:
@@ -112,32 +130,37 @@ private:
 	void CreateVertexBuffer();
 	void CreateIndexBuffer();
 	void CreateUniformBuffer();
-	void RecordCommandBuffer(vk::CommandBuffer buffer, uint32_t imageIndex);
-	void CreateAsyncObjects();
+	void RecordCommandBuffer(vk::CommandBuffer buffer, uint32_t imageIndex, uint32_t frameIndex);
+	void DrawScene(const RenderGraphContext& context);
 
 	void DrawFrame();
-	void UpdateUniformBuffers();
+	void UpdateUniformBuffers(uint32_t frameIndex);
+	vk::Format GetColorFormat() { return m_Headless ? m_Offscreen.GetFormat() : m_SwapChain.GetFormat(); }
+	vk::Extent2D GetExtent() { return m_Headless ? m_Offscreen.GetExtent() : m_SwapChain.GetExtent(); }
+	std::vector<Image>& GetColorTargets() { return m_Headless ? m_Offscreen.GetImages() : m_SwapChain.GetImages(); }
 private:
 	Device m_Device;
 	SwapChain m_SwapChain;
-	vk::CommandBuffer m_CommandBuffer;
+	OffscreenTarget m_Offscreen;
+	FrameRing m_FrameRing;
+	uint32_t m_HeadlessFrames = 1;
+	std::string m_OutputPath;
+	std::string m_ProfilePath;
+	bool m_IndirectDraw = true;
+	bool m_ParallelRecording = false;
+	PresentPolicy m_PresentPolicy;
+	bool m_DynamicRendering = false;
 	vk::SampleCountFlagBits m_SamplerCount = vk::SampleCountFlagBits::e1;
 
 	PipeLines m_PipeLines;
-	RenderPass BlinnPhongPass;
+	RenderGraph m_RenderGraph;
 	PipeLineLayout PipelineLayout;
 
-	//signals
-	vk::Fence m_InFlightFence;
-	vk::Semaphore m_WaitAcquireImageSemaphore;
-	vk::Semaphore m_WaitFinishDrawSemaphore;
-
-	vk::DescriptorPool m_DescriptorPool;
-	std::vector<vk::DescriptorPoolSize> m_PoolSizes;
-	uint32_t m_SetCount = 0;
-
 	Buffer m_CameraUniformBuffer;
 	Buffer m_LightUniformBuffer;
+	//one slice per frame in flight
+	vk::DeviceSize m_CameraUniformStride = 0;
+	vk::DeviceSize m_LightUniformStride = 0;
 	GlTFModel m_Model;
 	EditorCamera m_Camera;
 	PbrTexture m_PbrTextures;
@@ -1,11 +1,158 @@
 #include <iostream>
+#include <stdexcept>
+#include <string>
 #include "examples/PBRModel.h"
+#include "core/Benchmark.h"
 
 const static uint32_t WIDTH = 1920, HEIGHT = 1080;
 
-int main()
+static void PrintUsage()
 {
-	PBRModel app(WIDTH, HEIGHT, "vulkan");
+	std::cout << "usage: vulkanTutorial [--headless] [--frames N] [--output file.png] [--profile file.csv|file.json]" << std::endl;
+	std::cout << "       [--direct] [--no-bindless] [--parallel-record] [--dynamic-rendering]" << std::endl;
+	std::cout << "       [--vsync] [--images N] [--low-latency] [--max-fps F]" << std::endl;
+	std::cout << "       [--benchmark <example> [--warmup N] [--frames M] [--report file.json] [--baseline file.json [--update-baseline]] [--tolerance 0.1]]" << std::endl;
+}
+
+int main(int argc, char** argv)
+{
+	//--headless [--frames N] [--output file.png] renders offscreen without a window
+	//--profile file.csv|file.json dumps the profiler's min/avg/p99 per scope
+	//--direct records one draw per primitive instead of one indirect draw per material
+	//--no-bindless binds one descriptor set per material instead of the scene wide texture array
+	//--parallel-record records the scene pass into secondary command buffers on the job system workers
+	//--dynamic-rendering begins passes with vkCmdBeginRendering, no render pass or framebuffer objects
+	//--vsync, --images N, --low-latency, --max-fps F set the present policy: fifo, swapchain image count, input sampled after the oldest frame in flight finished, frame rate cap
+	//--benchmark <example> [--warmup N] [--frames M] [--report file.json] [--baseline file.json] [--tolerance 0.1]
+	//--update-baseline writes the benchmark report to the baseline file instead of comparing against it
+	bool headless = false;
+	bool benchmark = false;
+	uint32_t frameCount = 1;
+	std::string outputPath = "frame.png";
+	std::string profilePath;
+	bool indirectDraw = true;
+	bool bindless = true;
+	bool parallelRecording = false;
+	bool dynamicRendering = false;
+	PresentPolicy presentPolicy;
+	BenchmarkConfig benchmarkConfig;
+	benchmarkConfig.Width = WIDTH;
+	benchmarkConfig.Height = HEIGHT;
+	bool framesSet = false;
+	//a malformed number stops here instead of escaping main as an uncaught exception
+	try
+	{
+		for (int i = 1; i < argc; i++)
+		{
+			std::string arg = argv[i];
+			if (arg == "--headless")
+			{
+				headless = true;
+			}
+			else if (arg == "--frames" && i + 1 < argc)
+			{
+				frameCount = static_cast<uint32_t>(std::stoul(argv[++i]));
+				framesSet = true;
+			}
+			else if (arg == "--output" && i + 1 < argc)
+			{
+				outputPath = argv[++i];
+			}
+			else if (arg == "--direct")
+			{
+				indirectDraw = false;
+			}
+			else if (arg == "--no-bindless")
+			{
+				bindless = false;
+			}
+			else if (arg == "--parallel-record")
+			{
+				parallelRecording = true;
+			}
+			else if (arg == "--dynamic-rendering")
+			{
+				dynamicRendering = true;
+			}
+			else if (arg == "--vsync")
+			{
+				presentPolicy.VSync = true;
+			}
+			else if (arg == "--images" && i + 1 < argc)
+			{
+				presentPolicy.ImageCount = static_cast<uint32_t>(std::stoul(argv[++i]));
+			}
+			else if (arg == "--low-latency")
+			{
+				presentPolicy.LowLatency = true;
+			}
+			else if (arg == "--max-fps" && i + 1 < argc)
+			{
+				presentPolicy.MaxFps = std::stod(argv[++i]);
+			}
+			else if (arg == "--profile" && i + 1 < argc)
+			{
+				profilePath = argv[++i];
+			}
+			else if (arg == "--benchmark" && i + 1 < argc)
+			{
+				benchmark = true;
+				benchmarkConfig.Example = argv[++i];
+			}
+			else if (arg == "--warmup" && i + 1 < argc)
+			{
+				benchmarkConfig.WarmupFrames = static_cast<uint32_t>(std::stoul(argv[++i]));
+			}
+			else if (arg == "--report" && i + 1 < argc)
+			{
+				benchmarkConfig.ReportPath = argv[++i];
+			}
+			else if (arg == "--baseline" && i + 1 < argc)
+			{
+				benchmarkConfig.BaselinePath = argv[++i];
+			}
+			else if (arg == "--update-baseline")
+			{
+				benchmarkConfig.UpdateBaseline = true;
+			}
+			else if (arg == "--tolerance" && i + 1 < argc)
+			{
+				benchmarkConfig.Tolerance = std::stod(argv[++i]);
+			}
+		}
+	}
+	catch (const std::logic_error&)
+	{
+		PrintUsage();
+		return 1;
+	}
+
+	if (benchmark)
+	{
+		benchmarkConfig.Headless = headless;
+		if (framesSet)
+		{
+			benchmarkConfig.MeasuredFrames = frameCount;
+		}
+		try
+		{
+			return RunBenchmark(benchmarkConfig);
+		}
+		catch (const std::exception& e)
+		{
+			std::cout << e.what() << std::endl;
+			return 1;
+		}
+	}
+
+	PBRModel app(WIDTH, HEIGHT, "vulkan", headless);
+	app.SetHeadlessOutput(frameCount, outputPath);
+	app.SetProfileOutput(profilePath);
+	app.SetIndirectDraw(indirectDraw);
+	app.SetBindless(bindless);
+	app.SetParallelRecording(parallelRecording);
+	app.SetPresentPolicy(presentPolicy);
+	app.SetDynamicRendering(dynamicRendering);
 	try
 	{
 		app.Run();
@@ -14,4 +161,4 @@ int main()
 	{
 		std::cout << e.what() << std::endl;
 	}
-}
\ No newline at end of file
+}
@@ -17,11 +17,7 @@ void Buffer::Create(Device& device, vk::BufferUsageFlags usage, vk::DeviceSize s
 	VK_CHECK_RESULT(m_Device.GetLogicDevice().createBuffer(&bufferInfo, nullptr, &m_Buffer));
 	vk::MemoryRequirements requirement = m_Device.GetLogicDevice().getBufferMemoryRequirements(m_Buffer);
 	m_Alignment = requirement.alignment;
-	vk::MemoryAllocateInfo memoryInfo;
-	memoryInfo.sType = vk::StructureType::eMemoryAllocateInfo;
-	memoryInfo.setAllocationSize(requirement.size)
-			  .setMemoryTypeIndex(m_Device.FindMemoryType(requirement.memoryTypeBits, memoryFlags));
-	VK_CHECK_RESULT(m_Device.GetLogicDevice().allocateMemory(&memoryInfo, nullptr, &m_Memory));
+	m_Allocation = m_Device.GetAllocator().Allocate(requirement, memoryFlags, true);
 	SetDescriptor();
 	if (data)
 	{
@@ -38,21 +34,23 @@ void Buffer::Create(Device& device, vk::BufferUsageFlags usage, vk::DeviceSize s
 
 vk::Result Buffer::Map(vk::DeviceSize size, vk::DeviceSize offset)
 {
-	return m_Device.GetLogicDevice().mapMemory(m_Memory, offset, size, {}, &mapped);
+	//host visible blocks stay mapped for their whole lifetime, map only hands out the sub-range
+	if (!m_Allocation.Mapped)
+	{
+		return vk::Result::eErrorMemoryMapFailed;
+	}
+	mapped = static_cast<char*>(m_Allocation.Mapped) + offset;
+	return vk::Result::eSuccess;
 }
 
 void Buffer::Unmap()
 {
-	if (mapped)
-	{
-		m_Device.GetLogicDevice().unmapMemory(m_Memory);
-		mapped = nullptr;
-	}
+	mapped = nullptr;
 }
 
 void Buffer::Bind(vk::DeviceSize offset)
 {
-	m_Device.GetLogicDevice().bindBufferMemory(m_Buffer, m_Memory, offset);
+	m_Device.GetLogicDevice().bindBufferMemory(m_Buffer, m_Allocation.Memory, m_Allocation.Offset + offset);
 }
 
 void Buffer::SetDescriptor(vk::DeviceSize size, vk::DeviceSize offset)
@@ -76,9 +74,9 @@ vk::Result Buffer::Flush(vk::DeviceSize size, vk::DeviceSize offset)
 {
 	vk::MappedMemoryRange region;
 	region.sType = vk::StructureType::eMappedMemoryRange;
-	region.setMemory(m_Memory)
-		  .setOffset(offset)
-		  .setSize(size);
+	region.setMemory(m_Allocation.Memory)
+		  .setOffset(m_Allocation.Offset + offset)
+		  .setSize(size == VK_WHOLE_SIZE ? m_Allocation.Size - offset : size);
 	return m_Device.GetLogicDevice().flushMappedMemoryRanges(1, &region);
 }
 
@@ -86,9 +84,9 @@ vk::Result Buffer::Invalidate(vk::DeviceSize size, vk::DeviceSize offset)
 {
 	vk::MappedMemoryRange region;
 	region.sType = vk::StructureType::eMappedMemoryRange;
-	region.setMemory(m_Memory)
-		  .setSize(size)
-		  .setOffset(offset);
+	region.setMemory(m_Allocation.Memory)
+		  .setSize(size == VK_WHOLE_SIZE ? m_Allocation.Size - offset : size)
+		  .setOffset(m_Allocation.Offset + offset);
 	return m_Device.GetLogicDevice().invalidateMappedMemoryRanges(1, &region);
 }
 
@@ -97,23 +95,20 @@ void Buffer::Clear()
 	if (m_Buffer)
 	{
 		m_Device.GetLogicDevice().destroyBuffer(m_Buffer);
+		m_Buffer = nullptr;
 	}
-
-	if (m_Memory)
+	mapped = nullptr;
+	if (m_Allocation.IsValid())
 	{
-		m_Device.GetLogicDevice().freeMemory(m_Memory);
+		m_Device.GetAllocator().Free(m_Allocation);
 	}
 }
 
-void Buffer::CopyBuffer(vk::Buffer src, vk::DeviceSize srcOffset, vk::Buffer dst, vk::DeviceSize dstOffset, vk::DeviceSize size, vk::Queue queue, CommandManager& commandManager)
+void Buffer::CopyBuffer(vk::CommandBuffer command, vk::Buffer src, vk::DeviceSize srcOffset, vk::Buffer dst, vk::DeviceSize dstOffset, vk::DeviceSize size)
 {
-	auto command = commandManager.AllocateCommandBuffer(vk::CommandBufferLevel::ePrimary);
-
 	vk::BufferCopy region;
 	region.setDstOffset(dstOffset)
 		  .setSrcOffset(srcOffset)
 		  .setSize(size);
 	command.copyBuffer(src, dst, 1, &region);
-
-	commandManager.FlushCommandBuffer(command, queue);
 }
\ No newline at end of file
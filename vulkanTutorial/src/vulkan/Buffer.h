@@ -16,11 +16,11 @@ struct Buffer
 	vk::Result Flush(vk::DeviceSize size = VK_WHOLE_SIZE, vk::DeviceSize offset = 0);
 	vk::Result Invalidate(vk::DeviceSize size = VK_WHOLE_SIZE, vk::DeviceSize offset = 0);
 	void Clear();
-	static void CopyBuffer(vk::Buffer src, vk::DeviceSize srcOffset, vk::Buffer dst, vk::DeviceSize dstOffset, vk::DeviceSize size, vk::Queue queue, CommandManager& commandManager);
+	static void CopyBuffer(vk::CommandBuffer command, vk::Buffer src, vk::DeviceSize srcOffset, vk::Buffer dst, vk::DeviceSize dstOffset, vk::DeviceSize size);
 	uint64_t GetMemAddress() { return reinterpret_cast<uint64_t>(mapped); }
 	Device m_Device;
 	vk::Buffer m_Buffer = nullptr;
-	vk::DeviceMemory m_Memory = nullptr;
+	MemoryAllocation m_Allocation;
 	vk::DescriptorBufferInfo m_Descriptor;
 	vk::BufferUsageFlags m_Usage;
 	vk::DeviceSize m_Size = 0;;
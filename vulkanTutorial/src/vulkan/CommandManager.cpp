@@ -1,5 +1,6 @@
 #include "../Core.h"
 #include "CommandManager.h"
+#include <limits>
 
 void CommandManager::SetContext(vk::Device& device, uint32_t queueFamilyIndex)
 {
@@ -55,15 +56,19 @@ void CommandManager::CommandEnd(vk::CommandBuffer command)
 void CommandManager::FlushCommandBuffer(vk::CommandBuffer command, vk::Queue queue, vk::CommandPool pool, bool free)
 {
 	command.end();
+	vk::Fence fence;
 	vk::FenceCreateInfo fenceInfo;
 	fenceInfo.sType = vk::StructureType::eFenceCreateInfo;
 	fenceInfo.setFlags(vk::FenceCreateFlags());
+	VK_CHECK_RESULT(m_Device.createFence(&fenceInfo, nullptr, &fence));
 	vk::SubmitInfo submitInfo;
 	submitInfo.sType = vk::StructureType::eSubmitInfo;
 	submitInfo.setCommandBufferCount(1)
 			  .setPCommandBuffers(&command);
-	VK_CHECK_RESULT(queue.submit(1, &submitInfo, nullptr));
-	queue.waitIdle();
+	VK_CHECK_RESULT(queue.submit(1, &submitInfo, fence));
+	//wait for this submission only instead of draining the whole queue
+	VK_CHECK_RESULT(m_Device.waitForFences(1, &fence, VK_TRUE, (std::numeric_limits<uint64_t>::max)()));
+	m_Device.destroyFence(fence, nullptr);
 	if (free)
 	{
 		m_Device.freeCommandBuffers(pool, 1, &command);
@@ -1,5 +1,7 @@
 #pragma once
+#ifdef _WIN32
 #define VK_USE_PLATFORM_WIN32_KHR
+#endif
 #include <vulkan/vulkan.hpp>
 
 class CommandManager
@@ -1,42 +1,62 @@
 #include "../Core.h"
 #include "CubeMap.h"
+#include "../core/JobSystem.h"
 
 #include "stb_image.h"
-#include "Buffer.h"
+#include <cstring>
 
 void CubeMap::Create(Device& device, const std::vector<const char*>& paths)
 {
 	m_Device = device;
-	Buffer stagingBuffer;
-	vk::DeviceSize layerSize;
-	vk::DeviceSize imageSize;
-	stbi_uc* pixels = nullptr;
-	uint64_t memAddress;
+	//faces decode in parallel, then land in one staging range back to back
+	std::vector<stbi_uc*> faces(paths.size(), nullptr);
+	std::vector<int> widths(paths.size()), heights(paths.size());
+	JobCounter counter;
 	for (uint32_t i = 0; i < paths.size(); i++)
 	{
-		pixels = stbi_load(paths[i], &m_Width, &m_Height, &m_Channels, STBI_rgb_alpha);
-		if (pixels)
+		JobSystem::Get().Submit([&, i]() {
+			int channels = 0;
+			stbi_set_flip_vertically_on_load_thread(0);
+			faces[i] = stbi_load(paths[i], &widths[i], &heights[i], &channels, STBI_rgb_alpha);
+		}, &counter);
+	}
+	JobSystem::Get().Wait(counter);
+
+	//check every face before taking staging space, a failure then only has the decoded faces to free
+	bool failed = false;
+	for (uint32_t i = 0; i < faces.size(); i++)
+	{
+		failed = failed || !faces[i] || widths[i] != widths[0] || heights[i] != heights[0];
+	}
+	if (failed)
+	{
+		for (auto face : faces)
 		{
-			if (i == 0)
+			if (face)
 			{
-				layerSize = m_Width * m_Height * 4;
-				imageSize = layerSize * 6;
-				stagingBuffer.Create(device, vk::BufferUsageFlagBits::eTransferSrc, imageSize, vk::SharingMode::eExclusive, vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent, nullptr);
-				stagingBuffer.Map();
-				memAddress = stagingBuffer.GetMemAddress();
+				stbi_image_free(face);
 			}
-			stagingBuffer.CopyFrom(reinterpret_cast<void*>(memAddress), pixels, static_cast<size_t>(layerSize));
-			stbi_image_free(pixels);
-			memAddress += layerSize;
 		}
+		throw std::runtime_error("read cubemap face failed!");
+	}
+
+	m_Width = widths[0];
+	m_Height = heights[0];
+	m_Channels = 4;
+	vk::DeviceSize layerSize = static_cast<vk::DeviceSize>(m_Width) * m_Height * 4;
+	StagingRange staging = m_Device.GetStagingRing().Allocate(layerSize * faces.size());
+	char* memAddress = static_cast<char*>(staging.Mapped);
+	for (uint32_t i = 0; i < faces.size(); i++)
+	{
+		memcpy(memAddress + layerSize * i, faces[i], static_cast<size_t>(layerSize));
+		stbi_image_free(faces[i]);
 	}
-	stagingBuffer.Unmap();
 
 	m_Image.Create(device, 1, vk::SampleCountFlagBits::e1, vk::ImageType::e2D, vk::Extent3D(m_Width, m_Height, 1), vk::Format::eR8G8B8A8Srgb, vk::ImageUsageFlagBits::eTransferDst | vk::ImageUsageFlagBits::eSampled, vk::ImageTiling::eOptimal, vk::MemoryPropertyFlagBits::eDeviceLocal, vk::ImageLayout::eUndefined, vk::SharingMode::eExclusive, 6, vk::ImageCreateFlagBits::eCubeCompatible);
 	m_Image.CreateImageView(vk::Format::eR8G8B8A8Srgb, vk::ImageAspectFlagBits::eColor, vk::ImageViewType::eCube);
 
 	m_Image.TransiationLayout(vk::PipelineStageFlagBits::eTopOfPipe, vk::AccessFlagBits::eNone, vk::ImageLayout::eUndefined, vk::PipelineStageFlagBits::eTransfer, vk::AccessFlagBits::eTransferWrite, vk::ImageLayout::eTransferDstOptimal, vk::ImageAspectFlagBits::eColor);
-	m_Image.CopyBufferToImage(stagingBuffer.m_Buffer, vk::Extent3D(m_Width, m_Height, 1), vk::ImageLayout::eTransferDstOptimal);
+	m_Image.CopyBufferToImage(staging.Buffer, vk::Extent3D(m_Width, m_Height, 1), vk::ImageLayout::eTransferDstOptimal, staging.Offset);
 	m_Image.TransiationLayout(vk::PipelineStageFlagBits::eTransfer, vk::AccessFlagBits::eTransferWrite, vk::ImageLayout::eTransferDstOptimal, vk::PipelineStageFlagBits::eFragmentShader, vk::AccessFlagBits::eShaderRead, vk::ImageLayout::eShaderReadOnlyOptimal, vk::ImageAspectFlagBits::eColor);
 	CreateSampler();
 	CreateDescriptor();
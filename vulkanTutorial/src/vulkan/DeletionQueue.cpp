@@ -0,0 +1,50 @@
+#include "../Core.h"
+#include "DeletionQueue.h"
+
+void DeletionQueue::SetFramesInFlight(uint32_t framesInFlight)
+{
+	Flush();
+	m_AllSlots = framesInFlight >= 32 ? UINT32_MAX : (1u << framesInFlight) - 1;
+}
+
+void DeletionQueue::Release(std::function<void()> deleter)
+{
+	m_Entries.push_back({ std::move(deleter), m_AllSlots });
+	m_Stats.Pending = static_cast<uint32_t>(m_Entries.size());
+}
+
+void DeletionQueue::BeginFrame(uint32_t frameIndex)
+{
+	//a slot that was skipped and waited on again doesn't count twice, each slot's last submission has to be done
+	std::vector<Entry> ready;
+	for (size_t i = 0; i < m_Entries.size();)
+	{
+		m_Entries[i].Slots &= ~(1u << frameIndex);
+		if (m_Entries[i].Slots == 0)
+		{
+			ready.push_back(std::move(m_Entries[i]));
+			m_Entries.erase(m_Entries.begin() + i);
+			continue;
+		}
+		i++;
+	}
+	//in release order, a deleter may free what an earlier one's object was created from
+	for (auto& entry : ready)
+	{
+		entry.Deleter();
+	}
+	m_Stats.Released += static_cast<uint32_t>(ready.size());
+	m_Stats.Pending = static_cast<uint32_t>(m_Entries.size());
+}
+
+void DeletionQueue::Flush()
+{
+	std::vector<Entry> entries;
+	entries.swap(m_Entries);
+	for (auto& entry : entries)
+	{
+		entry.Deleter();
+	}
+	m_Stats.Released += static_cast<uint32_t>(entries.size());
+	m_Stats.Pending = 0;
+}
@@ -0,0 +1,35 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+struct DeletionQueueStats
+{
+	uint32_t Pending = 0;
+	uint32_t Released = 0;
+};
+
+//destroys objects the gpu may still be using once every frame slot's fence has been waited on since their release,
+//replaces a device wide waitIdle when something is swapped out in the middle of rendering
+class DeletionQueue
+{
+public:
+	void SetFramesInFlight(uint32_t framesInFlight);
+	void Release(std::function<void()> deleter);
+	//the slot's fence has been waited on
+	void BeginFrame(uint32_t frameIndex);
+	//every slot has been waited on, runs all pending deleters
+	void Flush();
+	const DeletionQueueStats& GetStats() const { return m_Stats; }
+private:
+	struct Entry
+	{
+		std::function<void()> Deleter;
+		//slots whose fence hasn't been waited on since the release
+		uint32_t Slots;
+	};
+private:
+	std::vector<Entry> m_Entries;
+	uint32_t m_AllSlots = 1;
+	DeletionQueueStats m_Stats;
+};
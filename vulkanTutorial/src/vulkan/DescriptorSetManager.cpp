@@ -0,0 +1,206 @@
+#include "../Core.h"
+#include "DescriptorSetManager.h"
+#include "../core/Hash.h"
+#include <algorithm>
+
+//descriptors per set a pool is sized for on top of what the requesting layout needs
+static const std::pair<vk::DescriptorType, float> PoolRatios[] = {
+	{ vk::DescriptorType::eUniformBuffer, 2.0f },
+	{ vk::DescriptorType::eUniformBufferDynamic, 1.0f },
+	{ vk::DescriptorType::eStorageBuffer, 2.0f },
+	{ vk::DescriptorType::eStorageBufferDynamic, 1.0f },
+	{ vk::DescriptorType::eCombinedImageSampler, 4.0f },
+	{ vk::DescriptorType::eSampledImage, 1.0f },
+	{ vk::DescriptorType::eStorageImage, 1.0f },
+	{ vk::DescriptorType::eInputAttachment, 0.5f },
+};
+
+void DescriptorSetManager::Create(vk::Device device, uint32_t setsPerPool)
+{
+	m_Device = device;
+	m_SetsPerPool = setsPerPool;
+}
+
+uint64_t DescriptorSetManager::HashBindings(const std::vector<DescriptorBinding>& bindings)
+{
+	uint64_t hash = HashSeed;
+	for (auto& binding : bindings)
+	{
+		hash = HashValue(hash, binding.Type);
+		hash = HashValue(hash, static_cast<VkShaderStageFlags>(binding.ShaderStage));
+		hash = HashValue(hash, binding.Binding);
+		hash = HashValue(hash, binding.DescriptorCount);
+		hash = HashValue(hash, static_cast<VkDescriptorBindingFlags>(binding.Flags));
+	}
+	return hash;
+}
+
+vk::DescriptorSetLayout DescriptorSetManager::GetLayout(const std::vector<DescriptorBinding>& bindings)
+{
+	uint64_t hash = HashBindings(bindings);
+	auto range = m_LayoutLookup.equal_range(hash);
+	for (auto it = range.first; it != range.second; it++)
+	{
+		if (m_Layouts[it->second].Bindings == bindings)
+		{
+			m_Stats.LayoutHits++;
+			return m_Layouts[it->second].Layout;
+		}
+	}
+
+	LayoutEntry entry;
+	entry.Bindings = bindings;
+	std::vector<vk::DescriptorSetLayoutBinding> setLayoutBindings(bindings.size());
+	std::vector<vk::DescriptorBindingFlags> bindingFlags(bindings.size());
+	vk::DescriptorSetLayoutCreateFlags layoutFlags;
+	bool hasFlags = false;
+	for (size_t i = 0; i < bindings.size(); i++)
+	{
+		const DescriptorBinding& binding = bindings[i];
+		setLayoutBindings[i].setBinding(binding.Binding)
+						    .setDescriptorCount(binding.DescriptorCount)
+						    .setDescriptorType(binding.Type)
+						    .setPImmutableSamplers(nullptr)
+						    .setStageFlags(binding.ShaderStage);
+		bindingFlags[i] = binding.Flags;
+		hasFlags = hasFlags || binding.Flags;
+		if (binding.Flags & vk::DescriptorBindingFlagBits::eUpdateAfterBind)
+		{
+			layoutFlags |= vk::DescriptorSetLayoutCreateFlagBits::eUpdateAfterBindPool;
+			entry.PoolFlags |= vk::DescriptorPoolCreateFlagBits::eUpdateAfterBind;
+		}
+		auto size = std::find_if(entry.Sizes.begin(), entry.Sizes.end(), [&](const vk::DescriptorPoolSize& poolSize) { return poolSize.type == binding.Type; });
+		if (size == entry.Sizes.end())
+		{
+			entry.Sizes.emplace_back(binding.Type, binding.DescriptorCount);
+		}
+		else
+		{
+			size->descriptorCount += binding.DescriptorCount;
+		}
+	}
+	vk::DescriptorSetLayoutBindingFlagsCreateInfo bindingFlagsInfo;
+	bindingFlagsInfo.sType = vk::StructureType::eDescriptorSetLayoutBindingFlagsCreateInfo;
+	bindingFlagsInfo.setBindingCount(static_cast<uint32_t>(bindingFlags.size()))
+					.setPBindingFlags(bindingFlags.data());
+	vk::DescriptorSetLayoutCreateInfo setLayoutInfo;
+	setLayoutInfo.sType = vk::StructureType::eDescriptorSetLayoutCreateInfo;
+	setLayoutInfo.setBindingCount(static_cast<uint32_t>(setLayoutBindings.size()))
+				 .setPBindings(setLayoutBindings.data())
+				 .setFlags(layoutFlags)
+				 .setPNext(hasFlags ? &bindingFlagsInfo : nullptr);
+	VK_CHECK_RESULT(m_Device.createDescriptorSetLayout(&setLayoutInfo, nullptr, &entry.Layout));
+
+	size_t index = m_Layouts.size();
+	m_Layouts.push_back(std::move(entry));
+	m_LayoutLookup.insert({ hash, index });
+	m_LayoutIndices[m_Layouts[index].Layout] = index;
+	m_Stats.LayoutsCreated++;
+	return m_Layouts[index].Layout;
+}
+
+vk::DescriptorSet DescriptorSetManager::Allocate(vk::DescriptorSetLayout layout)
+{
+	vk::DescriptorSet set;
+	Allocate(layout, 1, &set);
+	return set;
+}
+
+void DescriptorSetManager::Allocate(vk::DescriptorSetLayout layout, uint32_t count, vk::DescriptorSet* sets)
+{
+	const LayoutEntry& entry = m_Layouts[m_LayoutIndices.at(layout)];
+	m_Stats.Allocations += count;
+	AllocateFrom(GetPersistentList(entry.PoolFlags), entry, count, sets);
+}
+
+void DescriptorSetManager::AllocateFrom(PoolList& list, const LayoutEntry& layout, uint32_t count, vk::DescriptorSet* sets)
+{
+	std::vector<vk::DescriptorSetLayout> layouts(count, layout.Layout);
+	vk::DescriptorSetAllocateInfo setInfo;
+	setInfo.sType = vk::StructureType::eDescriptorSetAllocateInfo;
+	setInfo.setDescriptorSetCount(count)
+		   .setPSetLayouts(layouts.data());
+	//full pools are skipped
+	for (; list.Current < list.Pools.size(); list.Current++)
+	{
+		setInfo.setDescriptorPool(list.Pools[list.Current]);
+		vk::Result result = m_Device.allocateDescriptorSets(&setInfo, sets);
+		if (result == vk::Result::eSuccess)
+		{
+			return;
+		}
+		if (result != vk::Result::eErrorOutOfPoolMemory && result != vk::Result::eErrorFragmentedPool)
+		{
+			VK_CHECK_RESULT(result);
+		}
+	}
+	list.Pools.push_back(CreatePool(layout, list.Flags, count));
+	list.Current = list.Pools.size() - 1;
+	setInfo.setDescriptorPool(list.Pools.back());
+	VK_CHECK_RESULT(m_Device.allocateDescriptorSets(&setInfo, sets));
+}
+
+vk::DescriptorPool DescriptorSetManager::CreatePool(const LayoutEntry& layout, vk::DescriptorPoolCreateFlags flags, uint32_t setCount)
+{
+	//big enough for the sets that asked for it, with room for the common types of other sets
+	uint32_t maxSets = (std::max)(m_SetsPerPool, setCount);
+	std::vector<vk::DescriptorPoolSize> sizes;
+	for (auto& [type, ratio] : PoolRatios)
+	{
+		sizes.emplace_back(type, static_cast<uint32_t>(ratio * m_SetsPerPool));
+	}
+	for (auto& size : layout.Sizes)
+	{
+		auto it = std::find_if(sizes.begin(), sizes.end(), [&](const vk::DescriptorPoolSize& poolSize) { return poolSize.type == size.type; });
+		if (it == sizes.end())
+		{
+			sizes.emplace_back(size.type, size.descriptorCount * setCount);
+		}
+		else
+		{
+			it->descriptorCount = (std::max)(it->descriptorCount, size.descriptorCount * setCount);
+		}
+	}
+	vk::DescriptorPoolCreateInfo poolInfo;
+	poolInfo.sType = vk::StructureType::eDescriptorPoolCreateInfo;
+	poolInfo.setFlags(flags)
+			.setMaxSets(maxSets)
+			.setPoolSizeCount(static_cast<uint32_t>(sizes.size()))
+			.setPPoolSizes(sizes.data());
+	vk::DescriptorPool pool;
+	VK_CHECK_RESULT(m_Device.createDescriptorPool(&poolInfo, nullptr, &pool));
+	m_Stats.Pools++;
+	return pool;
+}
+
+DescriptorSetManager::PoolList& DescriptorSetManager::GetPersistentList(vk::DescriptorPoolCreateFlags flags)
+{
+	for (auto& list : m_Persistent)
+	{
+		if (list.Flags == flags)
+		{
+			return list;
+		}
+	}
+	m_Persistent.push_back({ flags });
+	return m_Persistent.back();
+}
+
+void DescriptorSetManager::Clear()
+{
+	for (auto& list : m_Persistent)
+	{
+		for (auto& pool : list.Pools)
+		{
+			m_Device.destroyDescriptorPool(pool, nullptr);
+		}
+	}
+	m_Persistent.clear();
+	for (auto& entry : m_Layouts)
+	{
+		m_Device.destroyDescriptorSetLayout(entry.Layout, nullptr);
+	}
+	m_Layouts.clear();
+	m_LayoutLookup.clear();
+	m_LayoutIndices.clear();
+}
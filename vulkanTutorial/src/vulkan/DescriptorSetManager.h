@@ -1,7 +1,65 @@
 #pragma once
 #include <vulkan/vulkan.hpp>
+#include <vector>
+#include <unordered_map>
 
-class DescriptorSetManager
+struct DescriptorBinding
+{
+	vk::DescriptorType Type;
+	vk::ShaderStageFlags ShaderStage;
+	uint32_t Binding;
+	uint32_t DescriptorCount = 1;
+	//partially bound or update after bind arrays, any update after bind binding needs a pool with the same flag
+	vk::DescriptorBindingFlags Flags = {};
+	bool operator==(const DescriptorBinding& other) const = default;
+};
+
+struct DescriptorSetManagerStats
 {
+	uint32_t Pools = 0;
+	uint32_t Allocations = 0;
+	uint32_t LayoutsCreated = 0;
+	uint32_t LayoutHits = 0;
+};
 
-};
\ No newline at end of file
+//hands out descriptor sets from pool lists that grow when a pool runs out, caches set layouts by binding signature
+class DescriptorSetManager
+{
+public:
+	void Create(vk::Device device, uint32_t setsPerPool = 64);
+	//layouts are owned by the manager, equal binding lists share one layout
+	vk::DescriptorSetLayout GetLayout(const std::vector<DescriptorBinding>& bindings);
+	//lives until Clear
+	vk::DescriptorSet Allocate(vk::DescriptorSetLayout layout);
+	//count sets of one layout with a single allocate call
+	void Allocate(vk::DescriptorSetLayout layout, uint32_t count, vk::DescriptorSet* sets);
+	const DescriptorSetManagerStats& GetStats() const { return m_Stats; }
+	void Clear();
+private:
+	struct LayoutEntry
+	{
+		std::vector<DescriptorBinding> Bindings;
+		vk::DescriptorSetLayout Layout;
+		//descriptors one set of this layout takes
+		std::vector<vk::DescriptorPoolSize> Sizes;
+		vk::DescriptorPoolCreateFlags PoolFlags;
+	};
+	struct PoolList
+	{
+		vk::DescriptorPoolCreateFlags Flags;
+		std::vector<vk::DescriptorPool> Pools;
+		size_t Current = 0;
+	};
+	void AllocateFrom(PoolList& list, const LayoutEntry& layout, uint32_t count, vk::DescriptorSet* sets);
+	vk::DescriptorPool CreatePool(const LayoutEntry& layout, vk::DescriptorPoolCreateFlags flags, uint32_t setCount);
+	PoolList& GetPersistentList(vk::DescriptorPoolCreateFlags flags);
+	static uint64_t HashBindings(const std::vector<DescriptorBinding>& bindings);
+private:
+	vk::Device m_Device;
+	uint32_t m_SetsPerPool = 64;
+	std::vector<LayoutEntry> m_Layouts;
+	std::unordered_multimap<uint64_t, size_t> m_LayoutLookup;
+	std::unordered_map<VkDescriptorSetLayout, size_t> m_LayoutIndices;
+	std::vector<PoolList> m_Persistent;
+	DescriptorSetManagerStats m_Stats;
+};
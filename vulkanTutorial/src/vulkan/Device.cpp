@@ -2,16 +2,53 @@
 #include "Device.h"
 #include <set>
 #include <string>
+#include <algorithm>
+#ifdef _WIN32
 #define GLFW_EXPOSE_NATIVE_WIN32
 #include <GLFW/glfw3native.h>
+#endif
 
-Device::Device(Window& window)
+Device::Device(Window& window) : Device(DeviceSpecification(), &window)
 {
+}
+
+Device::Device(const DeviceSpecification& specification, Window* window)
+{
+	m_Specification = specification;
+	if (m_Specification.Headless)
+	{
+		m_DeviceExtensions.clear();
+	}
+	else if (!window)
+	{
+		throw std::runtime_error("a window is required unless the device is headless!");
+	}
 	CreateInstance();
-	CreateSurface(window);
+	if (!m_Specification.Headless)
+	{
+		CreateSurface(*window);
+	}
 	PickPhysicalDevice();
 	CreateLogicDevice();
 	m_CommandManager.SetContext(m_LogicDevice, QueryQueueFamilyIndices(m_PhysicalDevice).GraphicQueueIndex.value());
+	m_Allocator = std::make_shared<MemoryAllocator>();
+	m_Allocator->Create(m_LogicDevice, m_PhysicalDevice);
+	m_UploadContext = std::make_shared<UploadContext>();
+	m_UploadContext->Create(m_LogicDevice, m_GraphicQueue, QueryQueueFamilyIndices(m_PhysicalDevice).GraphicQueueIndex.value());
+	m_StagingRing = std::make_shared<StagingRing>();
+	m_StagingRing->Create(m_LogicDevice, *m_Allocator, *m_UploadContext);
+	//query pools are created by the FrameRing that knows the number of frame slots
+	m_Profiler = std::make_shared<Profiler>();
+	m_PipelineRegistry = std::make_shared<PipelineRegistry>();
+	m_PipelineRegistry->Create(m_LogicDevice, m_Properties);
+	//frame scoped pools are added by the FrameRing
+	m_DescriptorSetManager = std::make_shared<DescriptorSetManager>();
+	m_DescriptorSetManager->Create(m_LogicDevice);
+	//per worker pools are added by the FrameRing as well
+	m_ParallelRecorder = std::make_shared<ParallelRecorder>();
+	m_ParallelRecorder->Create(m_LogicDevice, QueryQueueFamilyIndices(m_PhysicalDevice).GraphicQueueIndex.value());
+	//frame slots come from the FrameRing, which also drives it
+	m_DeletionQueue = std::make_shared<DeletionQueue>();
 }
 
 Device::~Device() {}
@@ -23,7 +60,11 @@ void Device::CreateInstance()
 	appInfo.setApiVersion(VK_API_VERSION_1_3);
 
 	uint32_t extensionCount = 0;
-	const char** extensions = glfwGetRequiredInstanceExtensions(&extensionCount);
+	const char** extensions = nullptr;
+	if (!m_Specification.Headless)
+	{
+		extensions = glfwGetRequiredInstanceExtensions(&extensionCount);
+	}
 
 	vk::InstanceCreateInfo instanceInfo;
 	instanceInfo.sType = vk::StructureType::eInstanceCreateInfo;
@@ -40,16 +81,27 @@ void Device::CreateInstance()
 
 void Device::CreateSurface(Window& window)
 {
+#ifdef _WIN32
 	vk::Win32SurfaceCreateInfoKHR surfaceInfo;
 	surfaceInfo.sType = vk::StructureType::eWin32SurfaceCreateInfoKHR;
 	surfaceInfo.setHwnd(glfwGetWin32Window(window.GetNativeWindow()))
 			   .setHinstance(GetModuleHandle(nullptr));
 	VK_CHECK_RESULT(m_VkInstance.createWin32SurfaceKHR(&surfaceInfo, nullptr, &m_Surface));
+#else
+	VkSurfaceKHR surface;
+	if (glfwCreateWindowSurface(m_VkInstance, window.GetNativeWindow(), nullptr, &surface) != VK_SUCCESS)
+	{
+		throw std::runtime_error("create window surface failed!");
+	}
+	m_Surface = surface;
+#endif
 }
 
 void Device::PickPhysicalDevice()
 {
 	auto devices = m_VkInstance.enumeratePhysicalDevices();
+	const auto& preferred = m_Specification.PreferredDeviceTypes;
+	size_t bestRank = preferred.size();
 	uint32_t index = 1;
 	for (auto& device : devices)
 	{
@@ -63,19 +115,55 @@ void Device::PickPhysicalDevice()
 		{
 			supportExtensions.erase(extension.extensionName);
 		}
+		//lower rank is a more preferred device type, ties keep the first device
+		size_t rank = std::find(preferred.begin(), preferred.end(), property.deviceType) - preferred.begin();
+		bool geometryShader = feature.geometryShader || !m_Specification.RequireGeometryShader;
+		bool swapchainSupport = m_Specification.Headless || QuerySwapchainASupport(device);
 		auto queueFamilyIndices = QueryQueueFamilyIndices(device);
-		if (property.deviceType == vk::PhysicalDeviceType::eDiscreteGpu && feature.geometryShader && supportExtensions.empty() && QuerySwapchainASupport(device) && queueFamilyIndices)
+		if (rank < bestRank && geometryShader && supportExtensions.empty() && swapchainSupport && queueFamilyIndices)
 		{
+			bestRank = rank;
 			m_PhysicalDevice = device;
 			m_QueueFamilyIndices = queueFamilyIndices;
 			m_MemoryProperties = device.getMemoryProperties();
-			m_MaxSamplerCount = CalcMaxSamplerCount(property);
+			m_Properties = property;
+			m_SupportedFeatures = feature;
+			m_SupportedFeatures12 = vk::PhysicalDeviceVulkan12Features();
+			m_SupportedFeatures13 = vk::PhysicalDeviceVulkan13Features();
+			m_Properties12 = vk::PhysicalDeviceVulkan12Properties();
+			if (property.apiVersion >= VK_API_VERSION_1_2)
+			{
+				vk::PhysicalDeviceFeatures2 features2;
+				features2.sType = vk::StructureType::ePhysicalDeviceFeatures2;
+				m_SupportedFeatures12.sType = vk::StructureType::ePhysicalDeviceVulkan12Features;
+				m_SupportedFeatures13.sType = vk::StructureType::ePhysicalDeviceVulkan13Features;
+				m_SupportedFeatures12.setPNext(property.apiVersion >= VK_API_VERSION_1_3 ? &m_SupportedFeatures13 : nullptr);
+				features2.setPNext(&m_SupportedFeatures12);
+				device.getFeatures2(&features2);
+				m_SupportedFeatures12.setPNext(nullptr);
+				m_SupportedFeatures13.setPNext(nullptr);
 
-			m_SurfaceFormats = m_PhysicalDevice.getSurfaceFormatsKHR(m_Surface);
-			m_SurfacePresentModes = m_PhysicalDevice.getSurfacePresentModesKHR(m_Surface);
-			m_SurfaceCapability = m_PhysicalDevice.getSurfaceCapabilitiesKHR(m_Surface);
+				vk::PhysicalDeviceProperties2 properties2;
+				properties2.sType = vk::StructureType::ePhysicalDeviceProperties2;
+				m_Properties12.sType = vk::StructureType::ePhysicalDeviceVulkan12Properties;
+				properties2.setPNext(&m_Properties12);
+				device.getProperties2(&properties2);
+				m_Properties12.setPNext(nullptr);
+			}
+			m_MaxSamplerCount = CalcMaxSamplerCount(property);
 		}
 	}
+	if (!m_PhysicalDevice)
+	{
+		throw std::runtime_error("no suitable physical device found!");
+	}
+	std::cout << "using:" << m_Properties.deviceName << std::endl;
+	if (!m_Specification.Headless)
+	{
+		m_SurfaceFormats = m_PhysicalDevice.getSurfaceFormatsKHR(m_Surface);
+		m_SurfacePresentModes = m_PhysicalDevice.getSurfacePresentModesKHR(m_Surface);
+		m_SurfaceCapability = m_PhysicalDevice.getSurfaceCapabilitiesKHR(m_Surface);
+	}
 }
 
 bool Device::QuerySwapchainASupport(const vk::PhysicalDevice& device)
@@ -96,11 +184,19 @@ QueueFamilyIndices Device::QueryQueueFamilyIndices(const vk::PhysicalDevice& dev
 		{
 			indices.GraphicQueueIndex = index;
 		}
-		vk::Bool32 presentSupported;
-		auto surfaceSupportRes = device.getSurfaceSupportKHR(index, m_Surface, &presentSupported);
-		if (presentSupported)
+		if (m_Specification.Headless)
+		{
+			//nothing is presented, the graphic queue stands in for the present queue
+			indices.PresentQueueIndex = indices.GraphicQueueIndex;
+		}
+		else
 		{
-			indices.PresentQueueIndex = index;
+			vk::Bool32 presentSupported;
+			auto surfaceSupportRes = device.getSurfaceSupportKHR(index, m_Surface, &presentSupported);
+			if (presentSupported)
+			{
+				indices.PresentQueueIndex = index;
+			}
 		}
 		if (indices)
 		{
@@ -115,10 +211,38 @@ void Device::CreateLogicDevice()
 {
 	vk::PhysicalDeviceFeatures feature;
 	feature.setSampleRateShading(true);
+	//optional features are on whenever the device has them, users check GetEnabledFeatures
+	feature.setMultiDrawIndirect(m_SupportedFeatures.multiDrawIndirect)
+		   .setDrawIndirectFirstInstance(m_SupportedFeatures.drawIndirectFirstInstance)
+		   .setFillModeNonSolid(m_SupportedFeatures.fillModeNonSolid);
+	m_EnabledFeatures = feature;
+	vk::PhysicalDeviceVulkan12Features features12;
+	features12.sType = vk::StructureType::ePhysicalDeviceVulkan12Features;
+	features12.setDrawIndirectCount(m_SupportedFeatures12.drawIndirectCount)
+			  .setRuntimeDescriptorArray(m_SupportedFeatures12.runtimeDescriptorArray)
+			  .setDescriptorBindingPartiallyBound(m_SupportedFeatures12.descriptorBindingPartiallyBound)
+			  .setDescriptorBindingSampledImageUpdateAfterBind(m_SupportedFeatures12.descriptorBindingSampledImageUpdateAfterBind)
+			  .setShaderSampledImageArrayNonUniformIndexing(m_SupportedFeatures12.shaderSampledImageArrayNonUniformIndexing);
+	vk::PhysicalDeviceVulkan13Features features13;
+	features13.sType = vk::StructureType::ePhysicalDeviceVulkan13Features;
+	features13.setDynamicRendering(m_SupportedFeatures13.dynamicRendering);
+	m_EnabledFeatures13 = features13;
+	if (m_Properties.apiVersion >= VK_API_VERSION_1_3)
+	{
+		features12.setPNext(&features13);
+	}
+	m_EnabledFeatures12 = features12;
+	m_EnabledFeatures12.setPNext(nullptr);
+	//the 1.2 feature struct is only known to devices that report 1.2
+	vk::PhysicalDeviceFeatures2 features2;
+	features2.sType = vk::StructureType::ePhysicalDeviceFeatures2;
+	features2.setFeatures(feature)
+			 .setPNext(m_Properties.apiVersion >= VK_API_VERSION_1_2 ? &features12 : nullptr);
 
 	float priority = 1.0f;
 	auto queueFamilyIndices = QueryQueueFamilyIndices(m_PhysicalDevice);
-	std::array<uint32_t, 2> queueIndices = { queueFamilyIndices.GraphicQueueIndex.value(), queueFamilyIndices.PresentQueueIndex.value() };
+	//one create info per distinct family, graphic and present are usually the same
+	std::set<uint32_t> queueIndices = { queueFamilyIndices.GraphicQueueIndex.value(), queueFamilyIndices.PresentQueueIndex.value() };
 	std::vector<vk::DeviceQueueCreateInfo> queueCreateInfos;
 	for (const uint32_t& index : queueIndices)
 	{
@@ -134,7 +258,8 @@ void Device::CreateLogicDevice()
 	deviceInfo.sType = vk::StructureType::eDeviceCreateInfo;
 	deviceInfo.setEnabledExtensionCount(static_cast<uint32_t>(m_DeviceExtensions.size()))
 			  .setPpEnabledExtensionNames(m_DeviceExtensions.data())
-			  .setPEnabledFeatures(&feature)
+			  .setPEnabledFeatures(nullptr)
+			  .setPNext(&features2)
 			  .setQueueCreateInfoCount(static_cast<uint32_t>(queueCreateInfos.size()))
 			  .setPQueueCreateInfos(queueCreateInfos.data());
 	VK_CHECK_RESULT(m_PhysicalDevice.createDevice(&deviceInfo, nullptr, &m_LogicDevice));
@@ -1,9 +1,20 @@
 #pragma once
+#ifdef _WIN32
 #define VK_USE_PLATFORM_WIN32_KHR
+#endif
 #include <vulkan/vulkan.hpp>
 #include "../Window.h"
 #include "CommandManager.h"
+#include "MemoryAllocator.h"
+#include "UploadContext.h"
+#include "StagingRing.h"
+#include "Profiler.h"
+#include "PipelineRegistry.h"
+#include "DescriptorSetManager.h"
+#include "ParallelRecorder.h"
+#include "DeletionQueue.h"
 #include <vector>
+#include <memory>
 #include <optional>
 
 struct QueueFamilyIndices
@@ -13,11 +24,21 @@ struct QueueFamilyIndices
 	operator bool() { return GraphicQueueIndex.has_value() && PresentQueueIndex.has_value(); }
 };
 
+struct DeviceSpecification
+{
+	//no surface and no swapchain, frames go to an OffscreenTarget
+	bool Headless = false;
+	//most preferred first, device types not listed are rejected
+	std::vector<vk::PhysicalDeviceType> PreferredDeviceTypes = { vk::PhysicalDeviceType::eDiscreteGpu };
+	bool RequireGeometryShader = true;
+};
+
 class Device
 {
 public:
 	Device() = default;
 	Device(Window& window);
+	Device(const DeviceSpecification& specification, Window* window = nullptr);
 	~Device();
 	vk::Device GetLogicDevice() { return m_LogicDevice; }
 	vk::PhysicalDevice GetPhysicalDevice() { return m_PhysicalDevice; }
@@ -39,7 +60,22 @@ public:
 		return m_SurfaceCapability; 
 	}
 	vk::SampleCountFlagBits GetMaxSampleCount() { return m_MaxSamplerCount; }
+	bool IsHeadless() const { return m_Specification.Headless; }
+	const vk::PhysicalDeviceProperties& GetProperties() { return m_Properties; }
+	//zeroed when the device is below Vulkan 1.2
+	const vk::PhysicalDeviceVulkan12Properties& GetProperties12() { return m_Properties12; }
+	const vk::PhysicalDeviceFeatures& GetEnabledFeatures() { return m_EnabledFeatures; }
+	const vk::PhysicalDeviceVulkan12Features& GetEnabledFeatures12() { return m_EnabledFeatures12; }
+	const vk::PhysicalDeviceVulkan13Features& GetEnabledFeatures13() { return m_EnabledFeatures13; }
 	CommandManager& GetCommandManager() { return m_CommandManager; }
+	MemoryAllocator& GetAllocator() { return *m_Allocator; }
+	UploadContext& GetUploadContext() { return *m_UploadContext; }
+	StagingRing& GetStagingRing() { return *m_StagingRing; }
+	Profiler& GetProfiler() { return *m_Profiler; }
+	PipelineRegistry& GetPipelineRegistry() { return *m_PipelineRegistry; }
+	DescriptorSetManager& GetDescriptorSetManager() { return *m_DescriptorSetManager; }
+	ParallelRecorder& GetParallelRecorder() { return *m_ParallelRecorder; }
+	DeletionQueue& GetDeletionQueue() { return *m_DeletionQueue; }
 	uint32_t FindMemoryType(uint32_t memoryTypeBits, vk::MemoryPropertyFlags flags);
 	bool QuerySwapchainASupport(const vk::PhysicalDevice& device);
 	QueueFamilyIndices QueryQueueFamilyIndices(const vk::PhysicalDevice& device);
@@ -54,16 +90,33 @@ private:
 	vk::SampleCountFlagBits CalcMaxSamplerCount(vk::PhysicalDeviceProperties properties);
 
 private:
+	DeviceSpecification m_Specification;
 	vk::Instance m_VkInstance;
 	vk::PhysicalDevice m_PhysicalDevice;
 	vk::Device m_LogicDevice;
 	vk::SurfaceKHR m_Surface; 
 	CommandManager m_CommandManager;
+	std::shared_ptr<MemoryAllocator> m_Allocator;
+	std::shared_ptr<UploadContext> m_UploadContext;
+	std::shared_ptr<StagingRing> m_StagingRing;
+	std::shared_ptr<Profiler> m_Profiler;
+	std::shared_ptr<PipelineRegistry> m_PipelineRegistry;
+	std::shared_ptr<DescriptorSetManager> m_DescriptorSetManager;
+	std::shared_ptr<ParallelRecorder> m_ParallelRecorder;
+	std::shared_ptr<DeletionQueue> m_DeletionQueue;
 	std::vector<const char*> m_DeviceExtensions = { VK_KHR_SWAPCHAIN_EXTENSION_NAME };
 	QueueFamilyIndices m_QueueFamilyIndices;
 	vk::Queue m_GraphicQueue;
 	vk::Queue m_PresentQueue;
 	vk::PhysicalDeviceMemoryProperties m_MemoryProperties;
+	vk::PhysicalDeviceProperties m_Properties;
+	vk::PhysicalDeviceVulkan12Properties m_Properties12;
+	vk::PhysicalDeviceFeatures m_SupportedFeatures;
+	vk::PhysicalDeviceFeatures m_EnabledFeatures;
+	vk::PhysicalDeviceVulkan12Features m_SupportedFeatures12;
+	vk::PhysicalDeviceVulkan12Features m_EnabledFeatures12;
+	vk::PhysicalDeviceVulkan13Features m_SupportedFeatures13;
+	vk::PhysicalDeviceVulkan13Features m_EnabledFeatures13;
 	vk::SampleCountFlagBits m_MaxSamplerCount;
 	std::vector<vk::SurfaceFormatKHR> m_SurfaceFormats;
 	std::vector<vk::PresentModeKHR> m_SurfacePresentModes;
@@ -0,0 +1,149 @@
+#include "../Core.h"
+#include "DrawList.h"
+#include <cstring>
+
+uint64_t DrawList::MakeKey(uint32_t pipelineId, uint32_t materialId, uint32_t firstIndex)
+{
+	//a wider id would alias another pipeline or material and break the bind elision
+	if (pipelineId >= MaxPipelines || materialId >= MaxMaterials)
+	{
+		throw std::runtime_error("draw list key overflow!");
+	}
+	return (static_cast<uint64_t>(pipelineId) << 56) | (static_cast<uint64_t>(materialId) << 32) | firstIndex;
+}
+
+void DrawList::Reset()
+{
+	m_Packets.clear();
+	m_Order.clear();
+	m_Pipelines.clear();
+}
+
+void DrawList::Add(vk::Pipeline pipeline, vk::DescriptorSet materialSet, uint32_t materialId, uint32_t firstIndex, uint32_t indexCount, uint32_t transformIndex)
+{
+	DrawPacket packet;
+	packet.Key = MakeKey(GetPipelineId(pipeline), materialId, firstIndex);
+	packet.Pipeline = pipeline;
+	packet.MaterialSet = materialSet;
+	packet.MaterialId = materialId;
+	packet.FirstIndex = firstIndex;
+	packet.IndexCount = indexCount;
+	packet.TransformIndex = transformIndex;
+	m_Order.push_back({ packet.Key, static_cast<uint32_t>(m_Packets.size()) });
+	m_Packets.push_back(packet);
+}
+
+void DrawList::Sort()
+{
+	//lsd radix sort, 8 bits per pass; a pass where every key has the same byte is skipped
+	size_t count = m_Order.size();
+	m_Scratch.resize(count);
+	uint32_t histograms[8][256];
+	memset(histograms, 0, sizeof(histograms));
+	for (auto& entry : m_Order)
+	{
+		for (uint32_t pass = 0; pass < 8; pass++)
+		{
+			histograms[pass][(entry.Key >> (pass * 8)) & 0xFF]++;
+		}
+	}
+	SortEntry* src = m_Order.data();
+	SortEntry* dst = m_Scratch.data();
+	for (uint32_t pass = 0; pass < 8; pass++)
+	{
+		uint32_t* histogram = histograms[pass];
+		if (count == 0 || histogram[(src[0].Key >> (pass * 8)) & 0xFF] == count)
+		{
+			continue;
+		}
+		uint32_t offset = 0;
+		for (uint32_t i = 0; i < 256; i++)
+		{
+			uint32_t bucket = histogram[i];
+			histogram[i] = offset;
+			offset += bucket;
+		}
+		for (size_t i = 0; i < count; i++)
+		{
+			dst[histogram[(src[i].Key >> (pass * 8)) & 0xFF]++] = src[i];
+		}
+		std::swap(src, dst);
+	}
+	if (src != m_Order.data())
+	{
+		m_Order.swap(m_Scratch);
+	}
+}
+
+void DrawList::Record(vk::CommandBuffer command, vk::PipelineLayout layout, uint32_t setIndex, const std::vector<uint32_t>& dynamicOffsets, vk::ShaderStageFlags materialStages)
+{
+	m_Stats = RecordRange(command, layout, setIndex, dynamicOffsets, materialStages, 0, static_cast<uint32_t>(m_Order.size()));
+}
+
+void DrawList::RecordParallel(ParallelRecorder& recorder, vk::CommandBuffer primary, const vk::CommandBufferInheritanceInfo& inheritance, const std::function<void(vk::CommandBuffer)>& bindState,
+							  vk::PipelineLayout layout, uint32_t setIndex, const std::vector<uint32_t>& dynamicOffsets, vk::ShaderStageFlags materialStages, uint32_t minChunkSize)
+{
+	uint32_t count = static_cast<uint32_t>(m_Order.size());
+	std::vector<DrawListStats> chunkStats(recorder.GetChunkCount(count, minChunkSize));
+	recorder.Record(primary, inheritance, count, minChunkSize, [&](vk::CommandBuffer command, uint32_t chunk, uint32_t first, uint32_t last) {
+		bindState(command);
+		chunkStats[chunk] = RecordRange(command, layout, setIndex, dynamicOffsets, materialStages, first, last);
+	});
+	//every chunk starts with nothing bound, so the bind counts are a bit higher than a single Record's
+	m_Stats = DrawListStats();
+	for (auto& stats : chunkStats)
+	{
+		m_Stats.Draws += stats.Draws;
+		m_Stats.PipelineBinds += stats.PipelineBinds;
+		m_Stats.SetBinds += stats.SetBinds;
+		m_Stats.MaterialPushes += stats.MaterialPushes;
+	}
+}
+
+DrawListStats DrawList::RecordRange(vk::CommandBuffer command, vk::PipelineLayout layout, uint32_t setIndex, const std::vector<uint32_t>& dynamicOffsets, vk::ShaderStageFlags materialStages, uint32_t first, uint32_t last) const
+{
+	DrawListStats stats;
+	vk::Pipeline boundPipeline;
+	vk::DescriptorSet boundSet;
+	bool pushed = false;
+	uint32_t pushedMaterial = 0;
+	for (uint32_t i = first; i < last; i++)
+	{
+		const DrawPacket& packet = m_Packets[m_Order[i].Packet];
+		if (packet.Pipeline != boundPipeline)
+		{
+			command.bindPipeline(vk::PipelineBindPoint::eGraphics, packet.Pipeline);
+			boundPipeline = packet.Pipeline;
+			stats.PipelineBinds++;
+		}
+		if (packet.MaterialSet != boundSet)
+		{
+			command.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, layout, setIndex, 1, &packet.MaterialSet, static_cast<uint32_t>(dynamicOffsets.size()), dynamicOffsets.data());
+			boundSet = packet.MaterialSet;
+			stats.SetBinds++;
+		}
+		if (materialStages && (!pushed || packet.MaterialId != pushedMaterial))
+		{
+			command.pushConstants(layout, materialStages, 0, sizeof(uint32_t), &packet.MaterialId);
+			pushed = true;
+			pushedMaterial = packet.MaterialId;
+			stats.MaterialPushes++;
+		}
+		command.drawIndexed(packet.IndexCount, 1, packet.FirstIndex, 0, packet.TransformIndex);
+		stats.Draws++;
+	}
+	return stats;
+}
+
+uint32_t DrawList::GetPipelineId(vk::Pipeline pipeline)
+{
+	for (uint32_t i = 0; i < m_Pipelines.size(); i++)
+	{
+		if (m_Pipelines[i] == pipeline)
+		{
+			return i;
+		}
+	}
+	m_Pipelines.push_back(pipeline);
+	return static_cast<uint32_t>(m_Pipelines.size() - 1);
+}
@@ -0,0 +1,62 @@
+#pragma once
+#include "ParallelRecorder.h"
+#include <vulkan/vulkan.hpp>
+#include <functional>
+#include <vector>
+
+struct DrawPacket
+{
+	uint64_t Key;
+	vk::Pipeline Pipeline;
+	vk::DescriptorSet MaterialSet;
+	uint32_t MaterialId;
+	uint32_t FirstIndex;
+	uint32_t IndexCount;
+	uint32_t TransformIndex;
+};
+
+struct DrawListStats
+{
+	uint32_t Draws = 0;
+	uint32_t PipelineBinds = 0;
+	uint32_t SetBinds = 0;
+	uint32_t MaterialPushes = 0;
+};
+
+//per frame list of draw packets, sorted by a state key so recording only binds what changes
+class DrawList
+{
+public:
+	void Reset();
+	void Add(vk::Pipeline pipeline, vk::DescriptorSet materialSet, uint32_t materialId, uint32_t firstIndex, uint32_t indexCount, uint32_t transformIndex);
+	void Sort();
+	//the material set is bound at setIndex with the given dynamic offsets, firstInstance carries the transform index
+	//with materialStages set the material id is also pushed as a uint at push constant offset 0
+	void Record(vk::CommandBuffer command, vk::PipelineLayout layout, uint32_t setIndex, const std::vector<uint32_t>& dynamicOffsets, vk::ShaderStageFlags materialStages = {});
+	//same as Record, split into secondaries on the job system; bindState sets up what the primary would have bound
+	//(viewport, scissor, buffers, other sets) at the start of every secondary
+	void RecordParallel(ParallelRecorder& recorder, vk::CommandBuffer primary, const vk::CommandBufferInheritanceInfo& inheritance, const std::function<void(vk::CommandBuffer)>& bindState,
+						vk::PipelineLayout layout, uint32_t setIndex, const std::vector<uint32_t>& dynamicOffsets, vk::ShaderStageFlags materialStages = {}, uint32_t minChunkSize = 256);
+	const std::vector<DrawPacket>& GetPackets() const { return m_Packets; }
+	const DrawListStats& GetStats() const { return m_Stats; }
+	//key layout, high to low: pipeline (8 bits), material (24 bits), first index (32 bits)
+	static constexpr uint32_t MaxPipelines = 1u << 8;
+	static constexpr uint32_t MaxMaterials = 1u << 24;
+	static uint64_t MakeKey(uint32_t pipelineId, uint32_t materialId, uint32_t firstIndex);
+private:
+	uint32_t GetPipelineId(vk::Pipeline pipeline);
+	//sorted packets [first, last), only reads the list so chunks can be recorded concurrently
+	DrawListStats RecordRange(vk::CommandBuffer command, vk::PipelineLayout layout, uint32_t setIndex, const std::vector<uint32_t>& dynamicOffsets, vk::ShaderStageFlags materialStages, uint32_t first, uint32_t last) const;
+private:
+	struct SortEntry
+	{
+		uint64_t Key;
+		uint32_t Packet;
+	};
+	std::vector<DrawPacket> m_Packets;
+	std::vector<SortEntry> m_Order;
+	std::vector<SortEntry> m_Scratch;
+	//small ids for the key, handed out per frame so destroyed pipelines never pile up
+	std::vector<vk::Pipeline> m_Pipelines;
+	DrawListStats m_Stats;
+};
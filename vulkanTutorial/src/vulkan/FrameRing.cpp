@@ -0,0 +1,204 @@
+#include "../Core.h"
+#include "FrameRing.h"
+#include <limits>
+
+void FrameRing::Create(Device& device, uint32_t framesInFlight)
+{
+	m_Device = device;
+	vk::Device vkDevice = m_Device.GetLogicDevice();
+	uint32_t queueFamilyIndex = m_Device.QueryQueueFamilyIndices(m_Device.GetPhysicalDevice()).GraphicQueueIndex.value();
+
+	vk::FenceCreateInfo fenceInfo;
+	fenceInfo.sType = vk::StructureType::eFenceCreateInfo;
+	fenceInfo.setFlags(vk::FenceCreateFlagBits::eSignaled);
+	vk::SemaphoreCreateInfo semaphoreInfo;
+	semaphoreInfo.sType = vk::StructureType::eSemaphoreCreateInfo;
+
+	m_Frames.resize(framesInFlight);
+	for (uint32_t i = 0; i < framesInFlight; i++)
+	{
+		FrameContext& frame = m_Frames[i];
+		frame.Index = i;
+		frame.Pool = m_Device.GetCommandManager().CreatePool(queueFamilyIndex, vk::CommandPoolCreateFlagBits::eTransient);
+		frame.Command = m_Device.GetCommandManager().AllocateCommandBuffer(vk::CommandBufferLevel::ePrimary, frame.Pool, false);
+		if (vkDevice.createFence(&fenceInfo, nullptr, &frame.InFlightFence) != vk::Result::eSuccess || vkDevice.createSemaphore(&semaphoreInfo, nullptr, &frame.ImageAcquired) != vk::Result::eSuccess)
+		{
+			throw std::runtime_error("create frame asyncObjects failed!");
+		}
+	}
+	m_Current = 0;
+	m_Device.GetProfiler().Create(vkDevice, m_Device.GetPhysicalDevice(), queueFamilyIndex, framesInFlight);
+	m_Device.GetParallelRecorder().SetFramesInFlight(framesInFlight);
+	m_Device.GetDeletionQueue().SetFramesInFlight(framesInFlight);
+}
+
+void FrameRing::SetPresentPolicy(const PresentPolicy& policy)
+{
+	m_LowLatency = policy.LowLatency;
+	m_Pacer.SetMaxFps(policy.MaxFps);
+}
+
+void FrameRing::Pace()
+{
+	{
+		ProfileScope scope(m_Device.GetProfiler(), "pacing");
+		m_Pacer.Wait();
+	}
+	FrameContext& frame = m_Frames[m_Current];
+	if (m_LowLatency)
+	{
+		//the oldest frame in flight, BeginFrame would block on it after input was already read
+		ProfileScope scope(m_Device.GetProfiler(), "latency wait");
+		VK_CHECK_RESULT(m_Device.GetLogicDevice().waitForFences(1, &frame.InFlightFence, VK_TRUE, (std::numeric_limits<uint64_t>::max)()));
+	}
+	frame.InputTime = std::chrono::steady_clock::now();
+	frame.InputSampled = true;
+}
+
+FrameContext* FrameRing::BeginFrame(SwapChain& swapChain, AppBase* app)
+{
+	FrameContext& frame = m_Frames[m_Current];
+	if (!frame.InputSampled)
+	{
+		frame.InputTime = std::chrono::steady_clock::now();
+	}
+	WaitFrame(frame);
+	{
+		ProfileScope scope(m_Device.GetProfiler(), "acquire");
+		if (!swapChain.AcquireNextImage(&frame.ImageIndex, frame.ImageAcquired, app))
+		{
+			//the fence stays signaled so the slot can be retried next frame
+			frame.InputSampled = false;
+			return nullptr;
+		}
+	}
+	UpdatePresentSemaphores(swapChain);
+	ResetFrame(frame);
+	return &frame;
+}
+
+void FrameRing::EndFrame(SwapChain& swapChain, AppBase* app)
+{
+	FrameContext& frame = m_Frames[m_Current];
+	vk::Semaphore renderFinished = m_RenderFinished[frame.ImageIndex];
+	SubmitFrame(frame, renderFinished);
+	{
+		ProfileScope scope(m_Device.GetProfiler(), "present");
+		swapChain.PresentImage(frame.ImageIndex, renderFinished, app);
+	}
+	std::chrono::duration<double, std::milli> latency = std::chrono::steady_clock::now() - frame.InputTime;
+	m_InputLatency = latency.count();
+	m_Device.GetProfiler().AddCpuSample("input to present", m_InputLatency);
+	frame.InputSampled = false;
+	m_Current = (m_Current + 1) % static_cast<uint32_t>(m_Frames.size());
+}
+
+FrameContext* FrameRing::BeginFrame()
+{
+	FrameContext& frame = m_Frames[m_Current];
+	WaitFrame(frame);
+	//the offscreen target has one image per slot
+	frame.ImageIndex = frame.Index;
+	ResetFrame(frame);
+	return &frame;
+}
+
+void FrameRing::EndFrame()
+{
+	SubmitFrame(m_Frames[m_Current], nullptr);
+	m_Current = (m_Current + 1) % static_cast<uint32_t>(m_Frames.size());
+}
+
+void FrameRing::WaitFrame(FrameContext& frame)
+{
+	{
+		//only this slot's previous submission has to be finished, the other slots keep the gpu busy
+		ProfileScope scope(m_Device.GetProfiler(), "frame wait");
+		VK_CHECK_RESULT(m_Device.GetLogicDevice().waitForFences(1, &frame.InFlightFence, VK_TRUE, (std::numeric_limits<uint64_t>::max)()));
+	}
+	m_Device.GetProfiler().NewFrame(frame.Index);
+	m_Device.GetParallelRecorder().BeginFrame(frame.Index);
+	m_Device.GetDeletionQueue().BeginFrame(frame.Index);
+}
+
+void FrameRing::ResetFrame(FrameContext& frame)
+{
+	vk::Device vkDevice = m_Device.GetLogicDevice();
+	VK_CHECK_RESULT(vkDevice.resetFences(1, &frame.InFlightFence));
+	vkDevice.resetCommandPool(frame.Pool, vk::CommandPoolResetFlags());
+}
+
+void FrameRing::SubmitFrame(FrameContext& frame, vk::Semaphore renderFinished)
+{
+	ProfileScope scope(m_Device.GetProfiler(), "submit");
+	vk::PipelineStageFlags waitStages[] = { vk::PipelineStageFlagBits::eColorAttachmentOutput };
+	vk::SubmitInfo submitInfo;
+	submitInfo.sType = vk::StructureType::eSubmitInfo;
+	submitInfo.setCommandBufferCount(1)
+			  .setPCommandBuffers(&frame.Command);
+	if (renderFinished)
+	{
+		submitInfo.setWaitSemaphoreCount(1)
+				  .setPWaitSemaphores(&frame.ImageAcquired)
+				  .setSignalSemaphoreCount(1)
+				  .setPSignalSemaphores(&renderFinished)
+				  .setPWaitDstStageMask(waitStages);
+	}
+	VK_CHECK_RESULT(m_Device.GetGraphicQueue().submit(1, &submitInfo, frame.InFlightFence));
+}
+
+void FrameRing::UpdatePresentSemaphores(SwapChain& swapChain)
+{
+	if (swapChain.GetSwapChain() == m_PresentSwapChain)
+	{
+		return;
+	}
+	vk::Device vkDevice = m_Device.GetLogicDevice();
+	if (!m_RenderFinished.empty())
+	{
+		m_Device.GetDeletionQueue().Release([vkDevice, semaphores = std::move(m_RenderFinished)]() {
+			for (auto& semaphore : semaphores)
+			{
+				vkDevice.destroySemaphore(semaphore, nullptr);
+			}
+		});
+	}
+	vk::SemaphoreCreateInfo semaphoreInfo;
+	semaphoreInfo.sType = vk::StructureType::eSemaphoreCreateInfo;
+	m_RenderFinished.assign(swapChain.GetImageCount(), nullptr);
+	for (auto& semaphore : m_RenderFinished)
+	{
+		VK_CHECK_RESULT(vkDevice.createSemaphore(&semaphoreInfo, nullptr, &semaphore));
+	}
+	m_PresentSwapChain = swapChain.GetSwapChain();
+}
+
+void FrameRing::WaitIdle()
+{
+	for (auto& frame : m_Frames)
+	{
+		VK_CHECK_RESULT(m_Device.GetLogicDevice().waitForFences(1, &frame.InFlightFence, VK_TRUE, (std::numeric_limits<uint64_t>::max)()));
+	}
+	m_Device.GetDeletionQueue().Flush();
+}
+
+void FrameRing::Clear()
+{
+	vk::Device vkDevice = m_Device.GetLogicDevice();
+	WaitIdle();
+	for (auto& frame : m_Frames)
+	{
+		vkDevice.destroySemaphore(frame.ImageAcquired, nullptr);
+		vkDevice.destroyFence(frame.InFlightFence, nullptr);
+		vkDevice.destroyCommandPool(frame.Pool, nullptr);
+	}
+	m_Frames.clear();
+	for (auto& semaphore : m_RenderFinished)
+	{
+		vkDevice.destroySemaphore(semaphore, nullptr);
+	}
+	m_RenderFinished.clear();
+	m_PresentSwapChain = nullptr;
+	m_Device.GetProfiler().Clear();
+	m_Device.GetParallelRecorder().Clear();
+}
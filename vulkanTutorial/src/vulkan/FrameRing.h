@@ -0,0 +1,63 @@
+#pragma once
+#include "Device.h"
+#include "SwapChain.h"
+#include "../AppBase.h"
+#include "../core/FramePacer.h"
+
+#include <vulkan/vulkan.hpp>
+#include <chrono>
+#include <vector>
+
+struct FrameContext
+{
+	vk::CommandPool Pool;
+	vk::CommandBuffer Command;
+	vk::Fence InFlightFence;
+	vk::Semaphore ImageAcquired;
+	uint32_t Index = 0;
+	uint32_t ImageIndex = 0;
+	//when the input this frame renders was sampled, set by Pace or else by BeginFrame
+	std::chrono::steady_clock::time_point InputTime;
+	bool InputSampled = false;
+};
+
+//N frame slots, the cpu records slot n+1 while the gpu still executes slot n
+class FrameRing
+{
+public:
+	void Create(Device& device, uint32_t framesInFlight = 2);
+	//the pacing part of the policy: frame rate cap and low latency wait
+	void SetPresentPolicy(const PresentPolicy& policy);
+	//call right before sampling input, applies the frame rate cap and in low latency mode waits for the slot the next frame reuses
+	void Pace();
+	FrameContext* BeginFrame(SwapChain& swapChain, AppBase* app);
+	void EndFrame(SwapChain& swapChain, AppBase* app);
+	//offscreen frames: no image to acquire and nothing to present
+	FrameContext* BeginFrame();
+	void EndFrame();
+	void WaitIdle();
+	void Clear();
+	FrameContext& GetFrame() { return m_Frames[m_Current]; }
+	uint32_t GetFrameIndex() const { return m_Current; }
+	uint32_t GetFramesInFlight() const { return static_cast<uint32_t>(m_Frames.size()); }
+	//from input sampling to the present call returning for the last presented frame, in milliseconds
+	double GetInputLatency() const { return m_InputLatency; }
+private:
+	void WaitFrame(FrameContext& frame);
+	void ResetFrame(FrameContext& frame);
+	//renderFinished is signaled by the submit and waited on by the present, null for offscreen frames
+	void SubmitFrame(FrameContext& frame, vk::Semaphore renderFinished);
+	//a new swapchain gets its own semaphores, the old ones may still be held by its last presents
+	void UpdatePresentSemaphores(SwapChain& swapChain);
+private:
+	Device m_Device;
+	std::vector<FrameContext> m_Frames;
+	//one per swapchain image rather than per slot: a present holds its semaphore until the image is acquired again,
+	//with more images than slots a per slot semaphore would be signaled again while a present still waits on it
+	std::vector<vk::Semaphore> m_RenderFinished;
+	vk::SwapchainKHR m_PresentSwapChain;
+	uint32_t m_Current = 0;
+	bool m_LowLatency = false;
+	FramePacer m_Pacer;
+	double m_InputLatency = 0.0;
+};
@@ -1,7 +1,7 @@
 #include "../Core.h"
 #include "Image.h"
 
-void Image::Create(Device& device, uint32_t mipLevels, vk::SampleCountFlagBits samplerCount, vk::ImageType type, vk::Extent3D size, vk::Format format, vk::ImageUsageFlags usage, vk::ImageTiling tiling, vk::MemoryPropertyFlags memoryFlags, vk::ImageLayout initialLayout, vk::SharingMode sharingMode, uint32_t arrayLayers, vk::ImageCreateFlags flag)
+void Image::CreateUnbound(Device& device, uint32_t mipLevels, vk::SampleCountFlagBits samplerCount, vk::ImageType type, vk::Extent3D size, vk::Format format, vk::ImageUsageFlags usage, vk::ImageTiling tiling, vk::ImageLayout initialLayout, vk::SharingMode sharingMode, uint32_t arrayLayers, vk::ImageCreateFlags flag)
 {
 	m_Device = device;
 	m_Size = size;
@@ -23,19 +23,28 @@ void Image::Create(Device& device, uint32_t mipLevels, vk::SampleCountFlagBits s
 		     .setUsage(usage)
 			 .setFlags(flag);
 	VK_CHECK_RESULT(vkDevice.createImage(&imageInfo, nullptr, &m_VkImage));
+}
+
+void Image::Create(Device& device, uint32_t mipLevels, vk::SampleCountFlagBits samplerCount, vk::ImageType type, vk::Extent3D size, vk::Format format, vk::ImageUsageFlags usage, vk::ImageTiling tiling, vk::MemoryPropertyFlags memoryFlags, vk::ImageLayout initialLayout, vk::SharingMode sharingMode, uint32_t arrayLayers, vk::ImageCreateFlags flag)
+{
+	CreateUnbound(device, mipLevels, samplerCount, type, size, format, usage, tiling, initialLayout, sharingMode, arrayLayers, flag);
+	m_Allocation = m_Device.GetAllocator().Allocate(GetMemoryRequirements(), memoryFlags, tiling == vk::ImageTiling::eLinear);
+	BindMemory(m_Allocation.Memory, m_Allocation.Offset);
+}
+
+vk::MemoryRequirements Image::GetMemoryRequirements()
+{
+	return m_Device.GetLogicDevice().getImageMemoryRequirements(m_VkImage);
+}
 
-	vk::MemoryRequirements requirement = vkDevice.getImageMemoryRequirements(m_VkImage);
-	vk::MemoryAllocateInfo memoryInfo;
-	memoryInfo.sType = vk::StructureType::eMemoryAllocateInfo;
-	memoryInfo.setAllocationSize(requirement.size)
-		      .setMemoryTypeIndex(m_Device.FindMemoryType(requirement.memoryTypeBits, memoryFlags));
-	VK_CHECK_RESULT(vkDevice.allocateMemory(&memoryInfo, nullptr, &m_Memory));
-	vkDevice.bindImageMemory(m_VkImage, m_Memory, 0);
+void Image::BindMemory(vk::DeviceMemory memory, vk::DeviceSize offset)
+{
+	m_Device.GetLogicDevice().bindImageMemory(m_VkImage, memory, offset);
 }
 
 void Image::TransiationLayout(vk::PipelineStageFlags srcStage, vk::AccessFlags srcAccess, vk::ImageLayout srcLayout, vk::PipelineStageFlags dstStage, vk::AccessFlags dstAccess, vk::ImageLayout dstLayout, vk::ImageAspectFlags aspectFlags)
 {
-	auto command = m_Device.GetCommandManager().AllocateCommandBuffer(vk::CommandBufferLevel::ePrimary);
+	auto command = m_Device.GetUploadContext().GetCommandBuffer();
 		vk::ImageSubresourceRange region;
 		region.setAspectMask(aspectFlags)
 			  .setBaseArrayLayer(0)
@@ -53,12 +62,11 @@ void Image::TransiationLayout(vk::PipelineStageFlags srcStage, vk::AccessFlags s
 			   .setDstQueueFamilyIndex(VK_QUEUE_FAMILY_IGNORED)
 			   .setNewLayout(dstLayout);
 		command.pipelineBarrier(srcStage, dstStage, {}, 0, nullptr, 0, nullptr, 1, &barrier);
-		m_Device.GetCommandManager().FlushCommandBuffer(command, m_Device.GetGraphicQueue());
 }
 
-void Image::CopyBufferToImage(vk::Buffer srcBuffer, vk::Extent3D size, vk::ImageLayout layout)
+void Image::CopyBufferToImage(vk::Buffer srcBuffer, vk::Extent3D size, vk::ImageLayout layout, vk::DeviceSize bufferOffset)
 {
-	auto command = m_Device.GetCommandManager().AllocateCommandBuffer(vk::CommandBufferLevel::ePrimary);
+	auto command = m_Device.GetUploadContext().GetCommandBuffer();
 
 	vk::ImageSubresourceLayers layer;
 	layer.setAspectMask(vk::ImageAspectFlagBits::eColor)
@@ -67,14 +75,12 @@ void Image::CopyBufferToImage(vk::Buffer srcBuffer, vk::Extent3D size, vk::Image
 		 .setMipLevel(0);
 	vk::BufferImageCopy region;
 	region.setBufferImageHeight(0)
-		  .setBufferOffset(0)
+		  .setBufferOffset(bufferOffset)
 		  .setBufferRowLength(0)
 		  .setImageExtent(size)
 		  .setImageOffset(0)
 		  .setImageSubresource(layer);
 	command.copyBufferToImage(srcBuffer, m_VkImage, layout, 1, &region);
-
-	m_Device.GetCommandManager().FlushCommandBuffer(command, m_Device.GetGraphicQueue());
 }
 
 void Image::GenerateMipMaps()
@@ -85,7 +91,7 @@ void Image::GenerateMipMaps()
 	}
 	uint32_t mipWidth = m_Size.width;
 	uint32_t mipHeight = m_Size.height;
-	auto command = m_Device.GetCommandManager().AllocateCommandBuffer(vk::CommandBufferLevel::ePrimary);
+	auto command = m_Device.GetUploadContext().GetCommandBuffer();
 
 	vk::ImageSubresourceRange region;
 	region.setAspectMask(vk::ImageAspectFlagBits::eColor)
@@ -147,8 +153,6 @@ void Image::GenerateMipMaps()
 		   .setDstAccessMask(vk::AccessFlagBits::eShaderRead)
 		   .setNewLayout(vk::ImageLayout::eShaderReadOnlyOptimal);
 	command.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eFragmentShader, {}, 0, nullptr, 0, nullptr, 1, &barrier);
-
-	m_Device.GetCommandManager().FlushCommandBuffer(command, m_Device.GetGraphicQueue());
 }
 
 void Image::CreateImageView(vk::Format format, vk::ImageAspectFlags aspectFlag, vk::ImageViewType viewType, vk::ComponentMapping mapping)
@@ -174,7 +178,10 @@ void Image::Clear()
 	vk::Device vkDevice = m_Device.GetLogicDevice();
 	vkDevice.destroyImageView(m_View, nullptr);
 	vkDevice.destroyImage(m_VkImage, nullptr);
-	vkDevice.freeMemory(m_Memory, nullptr);
+	if (m_Allocation.IsValid())
+	{
+		m_Device.GetAllocator().Free(m_Allocation);
+	}
 }
 
 void Image::CreateSampler()
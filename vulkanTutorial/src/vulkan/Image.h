@@ -7,8 +7,12 @@ class Image
 {
 public:
 	void Create(Device& device, uint32_t mipLevel, vk::SampleCountFlagBits samplerCount, vk::ImageType type, vk::Extent3D size, vk::Format format, vk::ImageUsageFlags usage, vk::ImageTiling tiling, vk::MemoryPropertyFlags memoryFlags, vk::ImageLayout initialLayout, vk::SharingMode sharingMode, uint32_t arrayLayers, vk::ImageCreateFlags flag);
+	//no memory of its own, the caller binds it into a range it owns, e.g. aliased render graph attachments
+	void CreateUnbound(Device& device, uint32_t mipLevel, vk::SampleCountFlagBits samplerCount, vk::ImageType type, vk::Extent3D size, vk::Format format, vk::ImageUsageFlags usage, vk::ImageTiling tiling, vk::ImageLayout initialLayout, vk::SharingMode sharingMode, uint32_t arrayLayers, vk::ImageCreateFlags flag);
+	vk::MemoryRequirements GetMemoryRequirements();
+	void BindMemory(vk::DeviceMemory memory, vk::DeviceSize offset);
 	void TransiationLayout(vk::PipelineStageFlags srcStage, vk::AccessFlags srcAccess, vk::ImageLayout srcLayout, vk::PipelineStageFlags dstStage, vk::AccessFlags dstAccess, vk::ImageLayout dstLayout, vk::ImageAspectFlags aspectFlags);
-	void CopyBufferToImage(vk::Buffer srcBuffer, vk::Extent3D size, vk::ImageLayout layout);
+	void CopyBufferToImage(vk::Buffer srcBuffer, vk::Extent3D size, vk::ImageLayout layout, vk::DeviceSize bufferOffset = 0);
 	void GenerateMipMaps();
 	void CreateImageView(vk::Format format, vk::ImageAspectFlags aspectFlag = vk::ImageAspectFlagBits::eColor, vk::ImageViewType viewType = vk::ImageViewType::e2D, vk::ComponentMapping mapping = vk::ComponentMapping());
 	vk::Image GetVkImage() { return m_VkImage; }
@@ -32,7 +36,7 @@ public:
 private:
 	Device m_Device;
 	vk::Image m_VkImage;
-	vk::DeviceMemory m_Memory;
+	MemoryAllocation m_Allocation;
 	vk::ImageView m_View;
 	vk::Extent3D m_Size;
 	vk::Format m_Format;
@@ -0,0 +1,246 @@
+#include "../Core.h"
+#include "MemoryAllocator.h"
+#include <algorithm>
+
+static vk::DeviceSize AlignUp(vk::DeviceSize value, vk::DeviceSize alignment)
+{
+	return (value + alignment - 1) / alignment * alignment;
+}
+
+void MemoryAllocator::Create(vk::Device device, vk::PhysicalDevice physicalDevice, vk::DeviceSize blockSize)
+{
+	m_Device = device;
+	m_BlockSize = blockSize;
+	m_MemoryProperties = physicalDevice.getMemoryProperties();
+	m_NonCoherentAtomSize = (std::max)(physicalDevice.getProperties().limits.nonCoherentAtomSize, vk::DeviceSize(1));
+}
+
+MemoryAllocation MemoryAllocator::Allocate(const vk::MemoryRequirements& requirement, vk::MemoryPropertyFlags flags, bool linear)
+{
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	uint32_t poolIndex = GetPool(FindMemoryType(requirement.memoryTypeBits, flags), linear);
+	MemoryPool& pool = m_Pools[poolIndex];
+
+	vk::DeviceSize alignment = (std::max)(requirement.alignment, vk::DeviceSize(1));
+	vk::DeviceSize size = requirement.size;
+	if (pool.HostVisible && !pool.HostCoherent)
+	{
+		//flush/invalidate ranges must be multiples of nonCoherentAtomSize
+		alignment = (std::max)(alignment, m_NonCoherentAtomSize);
+		size = AlignUp(size, m_NonCoherentAtomSize);
+	}
+
+	MemoryAllocation allocation;
+	allocation.PoolIndex = poolIndex;
+	allocation.Size = size;
+
+	uint32_t blockIndex = UINT32_MAX;
+	vk::DeviceSize offset = 0;
+	if (size > pool.BlockSize / 2)
+	{
+		blockIndex = CreateBlock(pool, size, true);
+		pool.Blocks[blockIndex].Ranges.Allocate(size, alignment, &offset);
+	}
+	else
+	{
+		for (uint32_t i = 0; i < pool.Blocks.size(); i++)
+		{
+			MemoryBlock& block = pool.Blocks[i];
+			if (block.Memory && !block.Dedicated && block.Ranges.Allocate(size, alignment, &offset))
+			{
+				blockIndex = i;
+				break;
+			}
+		}
+		if (blockIndex == UINT32_MAX)
+		{
+			blockIndex = CreateBlock(pool, pool.BlockSize, false);
+			if (!pool.Blocks[blockIndex].Ranges.Allocate(size, alignment, &offset))
+			{
+				throw std::runtime_error("memory block too small for allocation!");
+			}
+		}
+	}
+
+	MemoryBlock& block = pool.Blocks[blockIndex];
+	block.Used += size;
+	block.AllocationCount++;
+	allocation.Memory = block.Memory;
+	allocation.Offset = offset;
+	allocation.BlockIndex = blockIndex;
+	if (block.Mapped)
+	{
+		allocation.Mapped = static_cast<char*>(block.Mapped) + offset;
+	}
+	m_LiveBytes += size;
+	m_AllocationCount++;
+	return allocation;
+}
+
+void MemoryAllocator::Free(MemoryAllocation& allocation)
+{
+	if (!allocation.IsValid())
+	{
+		return;
+	}
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	MemoryPool& pool = m_Pools[allocation.PoolIndex];
+	MemoryBlock& block = pool.Blocks[allocation.BlockIndex];
+	block.Used -= allocation.Size;
+	block.AllocationCount--;
+	m_LiveBytes -= allocation.Size;
+	m_AllocationCount--;
+
+	if (block.Dedicated)
+	{
+		DestroyBlock(block);
+	}
+	else
+	{
+		block.Ranges.Free(allocation.Offset, allocation.Size);
+		if (block.AllocationCount == 0)
+		{
+			//keep a single empty block per pool around to absorb allocation churn
+			uint32_t emptyBlocks = 0;
+			for (auto& other : pool.Blocks)
+			{
+				if (other.Memory && !other.Dedicated && other.AllocationCount == 0)
+				{
+					emptyBlocks++;
+				}
+			}
+			if (emptyBlocks > 1)
+			{
+				DestroyBlock(block);
+			}
+		}
+	}
+	allocation = MemoryAllocation();
+}
+
+MemoryStats MemoryAllocator::GetStats()
+{
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	MemoryStats stats;
+	stats.LiveBytes = m_LiveBytes;
+	stats.ReservedBytes = m_ReservedBytes;
+	stats.PeakReservedBytes = m_PeakReservedBytes;
+	stats.AllocationCount = m_AllocationCount;
+	stats.DeviceAllocationCount = m_DeviceAllocationCount;
+	vk::DeviceSize totalFree = 0;
+	vk::DeviceSize largestPerBlock = 0;
+	for (auto& pool : m_Pools)
+	{
+		for (auto& block : pool.Blocks)
+		{
+			if (!block.Memory)
+			{
+				continue;
+			}
+			stats.BlockCount++;
+			vk::DeviceSize blockLargest = block.Ranges.GetLargestFreeRange();
+			totalFree += block.Ranges.GetFreeBytes();
+			largestPerBlock += blockLargest;
+			stats.LargestFreeRange = (std::max)(stats.LargestFreeRange, blockLargest);
+		}
+	}
+	if (totalFree > 0)
+	{
+		stats.Fragmentation = 1.0f - static_cast<float>(largestPerBlock) / static_cast<float>(totalFree);
+	}
+	return stats;
+}
+
+void MemoryAllocator::Clear()
+{
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	for (auto& pool : m_Pools)
+	{
+		for (auto& block : pool.Blocks)
+		{
+			DestroyBlock(block);
+		}
+	}
+	m_Pools.clear();
+}
+
+uint32_t MemoryAllocator::FindMemoryType(uint32_t memoryTypeBits, vk::MemoryPropertyFlags flags)
+{
+	for (uint32_t i = 0; i < m_MemoryProperties.memoryTypeCount; i++)
+	{
+		if ((memoryTypeBits & (1 << i)) && ((m_MemoryProperties.memoryTypes[i].propertyFlags & flags) == flags))
+		{
+			return i;
+		}
+	}
+	throw std::runtime_error("can not found suitable memoryType!");
+}
+
+uint32_t MemoryAllocator::GetPool(uint32_t memoryTypeIndex, bool linear)
+{
+	//linear and optimal resources live in separate pools so bufferImageGranularity never applies
+	for (uint32_t i = 0; i < m_Pools.size(); i++)
+	{
+		if (m_Pools[i].MemoryTypeIndex == memoryTypeIndex && m_Pools[i].Linear == linear)
+		{
+			return i;
+		}
+	}
+	vk::MemoryType memoryType = m_MemoryProperties.memoryTypes[memoryTypeIndex];
+	vk::DeviceSize heapSize = m_MemoryProperties.memoryHeaps[memoryType.heapIndex].size;
+	MemoryPool pool;
+	pool.MemoryTypeIndex = memoryTypeIndex;
+	pool.Linear = linear;
+	pool.HostVisible = static_cast<bool>(memoryType.propertyFlags & vk::MemoryPropertyFlagBits::eHostVisible);
+	pool.HostCoherent = static_cast<bool>(memoryType.propertyFlags & vk::MemoryPropertyFlagBits::eHostCoherent);
+	//small heaps (e.g. 256MB BAR memory) get proportionally smaller blocks
+	pool.BlockSize = (std::min)(m_BlockSize, (std::max)(heapSize / 8, vk::DeviceSize(1024 * 1024)));
+	m_Pools.push_back(pool);
+	return static_cast<uint32_t>(m_Pools.size() - 1);
+}
+
+uint32_t MemoryAllocator::CreateBlock(MemoryPool& pool, vk::DeviceSize size, bool dedicated)
+{
+	MemoryBlock block;
+	block.Size = size;
+	block.Dedicated = dedicated;
+	vk::MemoryAllocateInfo memoryInfo;
+	memoryInfo.sType = vk::StructureType::eMemoryAllocateInfo;
+	memoryInfo.setAllocationSize(size)
+			  .setMemoryTypeIndex(pool.MemoryTypeIndex);
+	VK_CHECK_RESULT(m_Device.allocateMemory(&memoryInfo, nullptr, &block.Memory));
+	if (pool.HostVisible)
+	{
+		VK_CHECK_RESULT(m_Device.mapMemory(block.Memory, 0, VK_WHOLE_SIZE, {}, &block.Mapped));
+	}
+	block.Ranges.Create(size);
+	m_ReservedBytes += size;
+	m_PeakReservedBytes = (std::max)(m_PeakReservedBytes, m_ReservedBytes);
+	m_DeviceAllocationCount++;
+
+	for (uint32_t i = 0; i < pool.Blocks.size(); i++)
+	{
+		if (!pool.Blocks[i].Memory)
+		{
+			pool.Blocks[i] = std::move(block);
+			return i;
+		}
+	}
+	pool.Blocks.push_back(std::move(block));
+	return static_cast<uint32_t>(pool.Blocks.size() - 1);
+}
+
+void MemoryAllocator::DestroyBlock(MemoryBlock& block)
+{
+	if (!block.Memory)
+	{
+		return;
+	}
+	if (block.Mapped)
+	{
+		m_Device.unmapMemory(block.Memory);
+	}
+	m_Device.freeMemory(block.Memory, nullptr);
+	m_ReservedBytes -= block.Size;
+	block = MemoryBlock();
+}
@@ -0,0 +1,80 @@
+#pragma once
+#include "../core/RangeAllocator.h"
+
+#include <vulkan/vulkan.hpp>
+#include <mutex>
+#include <vector>
+
+struct MemoryAllocation
+{
+	vk::DeviceMemory Memory = nullptr;
+	vk::DeviceSize Offset = 0;
+	vk::DeviceSize Size = 0;
+	void* Mapped = nullptr;
+	uint32_t PoolIndex = UINT32_MAX;
+	uint32_t BlockIndex = UINT32_MAX;
+	bool IsValid() const { return static_cast<bool>(Memory); }
+};
+
+struct MemoryStats
+{
+	vk::DeviceSize LiveBytes = 0;
+	vk::DeviceSize ReservedBytes = 0;
+	vk::DeviceSize PeakReservedBytes = 0;
+	vk::DeviceSize LargestFreeRange = 0;
+	uint32_t BlockCount = 0;
+	uint32_t AllocationCount = 0;
+	uint32_t DeviceAllocationCount = 0;
+	//1 - sum(largest free range per block) / totalFree, 0 when every block's free space is contiguous
+	float Fragmentation = 0.0f;
+};
+
+//sub-allocates resources out of large vk::DeviceMemory blocks, one pool per memory type and tiling class
+class MemoryAllocator
+{
+public:
+	void Create(vk::Device device, vk::PhysicalDevice physicalDevice, vk::DeviceSize blockSize = 64 * 1024 * 1024);
+	MemoryAllocation Allocate(const vk::MemoryRequirements& requirement, vk::MemoryPropertyFlags flags, bool linear);
+	void Free(MemoryAllocation& allocation);
+	MemoryStats GetStats();
+	vk::DeviceSize GetNonCoherentAtomSize() const { return m_NonCoherentAtomSize; }
+	void Clear();
+private:
+	struct MemoryBlock
+	{
+		vk::DeviceMemory Memory = nullptr;
+		vk::DeviceSize Size = 0;
+		vk::DeviceSize Used = 0;
+		void* Mapped = nullptr;
+		uint32_t AllocationCount = 0;
+		bool Dedicated = false;
+		RangeAllocator Ranges;
+	};
+
+	struct MemoryPool
+	{
+		uint32_t MemoryTypeIndex;
+		bool Linear;
+		bool HostVisible;
+		bool HostCoherent;
+		vk::DeviceSize BlockSize;
+		std::vector<MemoryBlock> Blocks;
+	};
+
+	uint32_t FindMemoryType(uint32_t memoryTypeBits, vk::MemoryPropertyFlags flags);
+	uint32_t GetPool(uint32_t memoryTypeIndex, bool linear);
+	uint32_t CreateBlock(MemoryPool& pool, vk::DeviceSize size, bool dedicated);
+	void DestroyBlock(MemoryBlock& block);
+private:
+	vk::Device m_Device;
+	vk::PhysicalDeviceMemoryProperties m_MemoryProperties;
+	vk::DeviceSize m_BlockSize = 0;
+	vk::DeviceSize m_NonCoherentAtomSize = 1;
+	std::vector<MemoryPool> m_Pools;
+	vk::DeviceSize m_LiveBytes = 0;
+	vk::DeviceSize m_ReservedBytes = 0;
+	vk::DeviceSize m_PeakReservedBytes = 0;
+	uint32_t m_AllocationCount = 0;
+	uint32_t m_DeviceAllocationCount = 0;
+	std::mutex m_Mutex;
+};
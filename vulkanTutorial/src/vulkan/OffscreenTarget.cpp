@@ -0,0 +1,105 @@
+#include "../Core.h"
+#include "OffscreenTarget.h"
+#include "stb_image_write.h"
+#include <cstring>
+
+void OffscreenTarget::Create(Device& device, uint32_t width, uint32_t height, uint32_t imageCount, vk::Format format)
+{
+	m_Device = device;
+	m_Format = format;
+	m_Extent = vk::Extent2D(width, height);
+
+	m_Images.resize(imageCount);
+	for (auto& colorImage : m_Images)
+	{
+		colorImage.Create(m_Device, 1, vk::SampleCountFlagBits::e1, vk::ImageType::e2D, vk::Extent3D(width, height, 1), format, vk::ImageUsageFlagBits::eColorAttachment | vk::ImageUsageFlagBits::eTransferSrc, vk::ImageTiling::eOptimal, vk::MemoryPropertyFlagBits::eDeviceLocal, vk::ImageLayout::eUndefined, vk::SharingMode::eExclusive, 1, {});
+		colorImage.CreateImageView(format);
+	}
+
+	vk::DeviceSize size = static_cast<vk::DeviceSize>(width) * height * 4;
+	m_ReadBackBuffer.Create(m_Device, vk::BufferUsageFlagBits::eTransferDst, size, vk::SharingMode::eExclusive, vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent, nullptr);
+	m_ReadBackBuffer.Map();
+}
+
+void OffscreenTarget::ReadBack(uint32_t imageIndex, std::vector<uint8_t>& pixels)
+{
+	vk::CommandBuffer command = m_Device.GetCommandManager().AllocateCommandBuffer(vk::CommandBufferLevel::ePrimary, true);
+
+	vk::ImageSubresourceRange range;
+	range.setAspectMask(vk::ImageAspectFlagBits::eColor)
+		 .setBaseArrayLayer(0)
+		 .setBaseMipLevel(0)
+		 .setLayerCount(1)
+		 .setLevelCount(1);
+	//the render pass already left the image in transfer src layout, only the writes need to be made visible
+	vk::ImageMemoryBarrier barrier;
+	barrier.sType = vk::StructureType::eImageMemoryBarrier;
+	barrier.setImage(m_Images[imageIndex].GetVkImage())
+		   .setSubresourceRange(range)
+		   .setSrcAccessMask(vk::AccessFlagBits::eColorAttachmentWrite)
+		   .setSrcQueueFamilyIndex(VK_QUEUE_FAMILY_IGNORED)
+		   .setOldLayout(vk::ImageLayout::eTransferSrcOptimal)
+		   .setDstAccessMask(vk::AccessFlagBits::eTransferRead)
+		   .setDstQueueFamilyIndex(VK_QUEUE_FAMILY_IGNORED)
+		   .setNewLayout(vk::ImageLayout::eTransferSrcOptimal);
+	command.pipelineBarrier(vk::PipelineStageFlagBits::eColorAttachmentOutput, vk::PipelineStageFlagBits::eTransfer, {}, 0, nullptr, 0, nullptr, 1, &barrier);
+
+	vk::ImageSubresourceLayers layer;
+	layer.setAspectMask(vk::ImageAspectFlagBits::eColor)
+		 .setBaseArrayLayer(0)
+		 .setLayerCount(1)
+		 .setMipLevel(0);
+	vk::BufferImageCopy region;
+	region.setBufferOffset(0)
+		  .setBufferRowLength(0)
+		  .setBufferImageHeight(0)
+		  .setImageSubresource(layer)
+		  .setImageOffset({ 0, 0, 0 })
+		  .setImageExtent(vk::Extent3D(m_Extent.width, m_Extent.height, 1));
+	command.copyImageToBuffer(m_Images[imageIndex].GetVkImage(), vk::ImageLayout::eTransferSrcOptimal, m_ReadBackBuffer.m_Buffer, 1, &region);
+
+	vk::BufferMemoryBarrier hostBarrier;
+	hostBarrier.sType = vk::StructureType::eBufferMemoryBarrier;
+	hostBarrier.setBuffer(m_ReadBackBuffer.m_Buffer)
+			   .setOffset(0)
+			   .setSize(VK_WHOLE_SIZE)
+			   .setSrcAccessMask(vk::AccessFlagBits::eTransferWrite)
+			   .setDstAccessMask(vk::AccessFlagBits::eHostRead)
+			   .setSrcQueueFamilyIndex(VK_QUEUE_FAMILY_IGNORED)
+			   .setDstQueueFamilyIndex(VK_QUEUE_FAMILY_IGNORED);
+	command.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eHost, {}, 0, nullptr, 1, &hostBarrier, 0, nullptr);
+	m_Device.GetCommandManager().FlushCommandBuffer(command, m_Device.GetGraphicQueue());
+
+	pixels.resize(static_cast<size_t>(m_ReadBackBuffer.m_Size));
+	memcpy(pixels.data(), m_ReadBackBuffer.mapped, pixels.size());
+}
+
+bool OffscreenTarget::SavePNG(uint32_t imageIndex, const std::string& path)
+{
+	std::vector<uint8_t> pixels;
+	ReadBack(imageIndex, pixels);
+	if (m_Format == vk::Format::eB8G8R8A8Srgb || m_Format == vk::Format::eB8G8R8A8Unorm)
+	{
+		for (size_t i = 0; i < pixels.size(); i += 4)
+		{
+			std::swap(pixels[i], pixels[i + 2]);
+		}
+	}
+	int stride = static_cast<int>(m_Extent.width) * 4;
+	if (!stbi_write_png(path.c_str(), static_cast<int>(m_Extent.width), static_cast<int>(m_Extent.height), 4, pixels.data(), stride))
+	{
+		std::cout << "failed to write " << path << std::endl;
+		return false;
+	}
+	return true;
+}
+
+void OffscreenTarget::Clear()
+{
+	for (auto& image : m_Images)
+	{
+		image.Clear();
+	}
+	m_Images.clear();
+	m_ReadBackBuffer.Clear();
+}
@@ -0,0 +1,29 @@
+#pragma once
+#include "Device.h"
+#include "Image.h"
+#include "Buffer.h"
+
+#include <vulkan/vulkan.hpp>
+#include <string>
+#include <vector>
+
+//color targets used instead of the swapchain on a headless device, one per frame slot so frames in flight never share an image
+//the render pass must leave them in eTransferSrcOptimal
+class OffscreenTarget
+{
+public:
+	void Create(Device& device, uint32_t width, uint32_t height, uint32_t imageCount, vk::Format format = vk::Format::eR8G8B8A8Srgb);
+	void ReadBack(uint32_t imageIndex, std::vector<uint8_t>& pixels);
+	bool SavePNG(uint32_t imageIndex, const std::string& path);
+	vk::Format GetFormat() { return m_Format; }
+	vk::Extent2D GetExtent() { return m_Extent; }
+	uint32_t GetImageCount() { return static_cast<uint32_t>(m_Images.size()); }
+	std::vector<Image>& GetImages() { return m_Images; }
+	void Clear();
+private:
+	Device m_Device;
+	vk::Format m_Format = vk::Format::eR8G8B8A8Srgb;
+	vk::Extent2D m_Extent = { 0, 0 };
+	std::vector<Image> m_Images;
+	Buffer m_ReadBackBuffer;
+};
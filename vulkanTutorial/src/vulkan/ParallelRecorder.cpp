@@ -0,0 +1,125 @@
+#include "../Core.h"
+#include "ParallelRecorder.h"
+#include "../core/JobSystem.h"
+#include <algorithm>
+
+void ParallelRecorder::Create(vk::Device device, uint32_t queueFamilyIndex)
+{
+	m_Device = device;
+	m_QueueFamilyIndex = queueFamilyIndex;
+}
+
+void ParallelRecorder::SetFramesInFlight(uint32_t framesInFlight)
+{
+	Clear();
+	//the calling thread records too, it is thread index 0
+	uint32_t threadCount = JobSystem::Get().GetWorkerCount() + 1;
+	vk::CommandPoolCreateInfo poolInfo;
+	poolInfo.sType = vk::StructureType::eCommandPoolCreateInfo;
+	poolInfo.setQueueFamilyIndex(m_QueueFamilyIndex)
+			.setFlags(vk::CommandPoolCreateFlagBits::eTransient);
+	m_Pools.resize(framesInFlight);
+	for (auto& framePools : m_Pools)
+	{
+		framePools.resize(threadCount);
+		for (auto& threadPool : framePools)
+		{
+			VK_CHECK_RESULT(m_Device.createCommandPool(&poolInfo, nullptr, &threadPool.Pool));
+		}
+	}
+	m_Frame = 0;
+}
+
+void ParallelRecorder::BeginFrame(uint32_t frameIndex)
+{
+	m_Frame = frameIndex;
+	//one reset per pool, the buffers stay allocated for the next time round
+	for (auto& threadPool : m_Pools[frameIndex])
+	{
+		m_Device.resetCommandPool(threadPool.Pool, vk::CommandPoolResetFlags());
+		threadPool.Used = 0;
+	}
+}
+
+vk::CommandBuffer ParallelRecorder::Acquire()
+{
+	//only the owning thread touches its pool
+	ThreadPool& threadPool = m_Pools[m_Frame][JobSystem::GetThreadIndex()];
+	if (threadPool.Used == threadPool.Buffers.size())
+	{
+		vk::CommandBufferAllocateInfo allocateInfo;
+		allocateInfo.sType = vk::StructureType::eCommandBufferAllocateInfo;
+		allocateInfo.setCommandPool(threadPool.Pool)
+					.setLevel(vk::CommandBufferLevel::eSecondary)
+					.setCommandBufferCount(1);
+		vk::CommandBuffer command;
+		VK_CHECK_RESULT(m_Device.allocateCommandBuffers(&allocateInfo, &command));
+		threadPool.Buffers.push_back(command);
+	}
+	return threadPool.Buffers[threadPool.Used++];
+}
+
+uint32_t ParallelRecorder::GetChunkCount(uint32_t count, uint32_t minChunkSize) const
+{
+	//two chunks per thread evens out chunks that record slower than others
+	uint32_t threadCount = static_cast<uint32_t>(m_Pools[m_Frame].size());
+	uint32_t chunkSize = (std::max)((std::max)(minChunkSize, 1u), (count + threadCount * 2 - 1) / (threadCount * 2));
+	return (std::max)(1u, (count + chunkSize - 1) / chunkSize);
+}
+
+void ParallelRecorder::Record(vk::CommandBuffer primary, const vk::CommandBufferInheritanceInfo& inheritance, uint32_t count, uint32_t minChunkSize, const std::function<void(vk::CommandBuffer, uint32_t chunk, uint32_t first, uint32_t last)>& record)
+{
+	uint32_t chunkCount = GetChunkCount(count, minChunkSize);
+	uint32_t chunkSize = (count + chunkCount - 1) / chunkCount;
+	std::vector<vk::CommandBuffer> secondaries(chunkCount);
+	auto recordChunk = [&, chunkSize](uint32_t chunk) {
+		vk::CommandBuffer command = Acquire();
+		vk::CommandBufferBeginInfo beginInfo;
+		beginInfo.sType = vk::StructureType::eCommandBufferBeginInfo;
+		beginInfo.setFlags(vk::CommandBufferUsageFlagBits::eRenderPassContinue | vk::CommandBufferUsageFlagBits::eOneTimeSubmit)
+				 .setPInheritanceInfo(&inheritance);
+		VK_CHECK_RESULT(command.begin(&beginInfo));
+		uint32_t first = chunk * chunkSize;
+		record(command, chunk, first, (std::min)(count, first + chunkSize));
+		command.end();
+		secondaries[chunk] = command;
+	};
+	if (chunkCount == 1)
+	{
+		recordChunk(0);
+	}
+	else
+	{
+		JobSystem& jobs = JobSystem::Get();
+		JobCounter counter;
+		for (uint32_t chunk = 0; chunk < chunkCount; chunk++)
+		{
+			jobs.Submit([&recordChunk, chunk]() { recordChunk(chunk); }, &counter);
+		}
+		jobs.Wait(counter);
+	}
+	primary.executeCommands(static_cast<uint32_t>(secondaries.size()), secondaries.data());
+
+	m_Stats.Chunks = chunkCount;
+	m_Stats.SecondaryBuffers = 0;
+	for (auto& framePools : m_Pools)
+	{
+		for (auto& threadPool : framePools)
+		{
+			m_Stats.SecondaryBuffers += static_cast<uint32_t>(threadPool.Buffers.size());
+		}
+	}
+}
+
+void ParallelRecorder::Clear()
+{
+	//destroying a pool frees its buffers
+	for (auto& framePools : m_Pools)
+	{
+		for (auto& threadPool : framePools)
+		{
+			m_Device.destroyCommandPool(threadPool.Pool, nullptr);
+		}
+	}
+	m_Pools.clear();
+}
@@ -0,0 +1,43 @@
+#pragma once
+#include <vulkan/vulkan.hpp>
+#include <functional>
+#include <vector>
+
+struct ParallelRecorderStats
+{
+	uint32_t Chunks = 0;
+	uint32_t SecondaryBuffers = 0;
+};
+
+//records chunks of a render pass into secondary command buffers on the job system workers,
+//every worker has its own pool per frame slot so recording never takes a lock
+class ParallelRecorder
+{
+public:
+	void Create(vk::Device device, uint32_t queueFamilyIndex);
+	void SetFramesInFlight(uint32_t framesInFlight);
+	//the slot's fence has been waited on, its secondaries can be recorded again
+	void BeginFrame(uint32_t frameIndex);
+	//splits [0, count) into chunks of at least minChunkSize, record gets each chunk's secondary and range,
+	//the secondaries are executed on primary in chunk order, the render pass must be begun with eSecondaryCommandBuffers
+	void Record(vk::CommandBuffer primary, const vk::CommandBufferInheritanceInfo& inheritance, uint32_t count, uint32_t minChunkSize, const std::function<void(vk::CommandBuffer, uint32_t chunk, uint32_t first, uint32_t last)>& record);
+	//number of chunks Record splits count into
+	uint32_t GetChunkCount(uint32_t count, uint32_t minChunkSize) const;
+	const ParallelRecorderStats& GetStats() const { return m_Stats; }
+	void Clear();
+private:
+	struct ThreadPool
+	{
+		vk::CommandPool Pool;
+		std::vector<vk::CommandBuffer> Buffers;
+		size_t Used = 0;
+	};
+	vk::CommandBuffer Acquire();
+private:
+	vk::Device m_Device;
+	uint32_t m_QueueFamilyIndex = 0;
+	//frame slot, then job system thread index
+	std::vector<std::vector<ThreadPool>> m_Pools;
+	uint32_t m_Frame = 0;
+	ParallelRecorderStats m_Stats;
+};
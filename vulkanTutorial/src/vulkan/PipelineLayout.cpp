@@ -1,34 +1,33 @@
 #include "../Core.h"
 #include "PipelineLayout.h"
+#include <algorithm>
+
+//template data for one descriptor, big enough for either info struct
+union DescriptorTemplateSlot
+{
+	VkDescriptorImageInfo Image;
+	VkDescriptorBufferInfo Buffer;
+};
 
 void PipeLineLayout::Create(const Device& device, const std::vector<DescriptorSetLayoutCreateInfo>& setLayouts, const std::vector<vk::PushConstantRange>& pushConsnts)
 {
 	m_Device = device;
-	vk::Device vkDevice = m_Device.GetLogicDevice();
 	m_BindingParams = setLayouts;
 	m_SetlayoutCount = setLayouts.size();
 	m_SetLayouts.resize(m_SetlayoutCount);	
 	for (uint32_t i = 0; i < m_SetlayoutCount; i++)
 	{
-		m_SetCount += setLayouts[i].SetCount;
-		std::vector<vk::DescriptorSetLayoutBinding> setLayoutBindings = {};
-		uint32_t bindingCount = setLayouts[i].Bindings.size();
-		setLayoutBindings.resize(bindingCount);
-		for (uint32_t j = 0; j < bindingCount; j++)
+		//equal binding lists share one cached layout, so rebuilding a pipeline layout creates no new set layouts
+		m_SetLayouts[i] = m_Device.GetDescriptorSetManager().GetLayout(setLayouts[i].Bindings);
+	}
+	m_Templates.assign(m_SetlayoutCount, nullptr);
+	m_TemplateSlots.assign(m_SetlayoutCount, 0);
+	for (uint32_t i = 0; i < m_SetlayoutCount; i++)
+	{
+		if (setLayouts[i].UseUpdateTemplate)
 		{
-			const DescriptorBinding& currentBinding = setLayouts[i].Bindings[j];
-			setLayoutBindings[j].setBinding(currentBinding.Binding)
-							    .setDescriptorCount(currentBinding.DescriptorCount)
-							    .setDescriptorType(currentBinding.Type)
-							    .setPImmutableSamplers(nullptr)
-							    .setStageFlags(currentBinding.ShaderStage);
-			m_PoolSizes.emplace_back(currentBinding.Type, setLayouts[i].SetCount * currentBinding.DescriptorCount);
+			CreateUpdateTemplate(i);
 		}
-		vk::DescriptorSetLayoutCreateInfo setLayoutInfo;
-		setLayoutInfo.sType = vk::StructureType::eDescriptorSetLayoutCreateInfo;
-		setLayoutInfo.setBindingCount(setLayoutBindings.size())
-				     .setPBindings(setLayoutBindings.data());
-		VK_CHECK_RESULT(vkDevice.createDescriptorSetLayout(&setLayoutInfo, nullptr, &m_SetLayouts[i]));
 	}
 	vk::PipelineLayoutCreateInfo layoutInfo;
 	layoutInfo.sType = vk::StructureType::ePipelineLayoutCreateInfo;
@@ -39,47 +38,188 @@ void PipeLineLayout::Create(const Device& device, const std::vector<DescriptorSe
 	VK_CHECK_RESULT(m_Device.GetLogicDevice().createPipelineLayout(&layoutInfo, nullptr, &m_PipelineLayout));
 }
 
-void PipeLineLayout::BuildAndUpdateSet(vk::DescriptorPool pool)
+void PipeLineLayout::BuildAndUpdateSet()
 {
+	ProfileScope scope(m_Device.GetProfiler(), "descriptor build");
 	m_DescriptorSets.resize(m_SetlayoutCount);
+	std::vector<vk::WriteDescriptorSet> writeSets;
 	for (uint32_t i = 0; i < m_SetlayoutCount; i++)
 	{
 		m_DescriptorSets[i].SetLayout = m_SetLayouts[i];
 		uint32_t setCount = m_BindingParams[i].SetCount;
 		m_DescriptorSets[i].DescriptorSets.resize(setCount);
-		
+		if (setCount == 0)
+		{
+			continue;
+		}
+		//all sets of a layout come from one allocate call
+		m_Device.GetDescriptorSetManager().Allocate(m_SetLayouts[i], setCount, m_DescriptorSets[i].DescriptorSets.data());
+
 		for (uint32_t j = 0; j < setCount; j++)
 		{
-			vk::DescriptorSetAllocateInfo setInfo;
-			setInfo.sType = vk::StructureType::eDescriptorSetAllocateInfo;
-			setInfo.setDescriptorPool(pool)
-				   .setDescriptorSetCount(1)
-				   .setPSetLayouts(&m_SetLayouts[i]);
-			VK_CHECK_RESULT(m_Device.GetLogicDevice().allocateDescriptorSets(&setInfo, &m_DescriptorSets[i].DescriptorSets[j]));
+			if (m_Templates[i])
+			{
+				UpdateWithTemplate(i, j);
+			}
+			else
+			{
+				AppendWrites(i, j, writeSets);
+			}
+		}
+	}
+	//the write data lives in m_BindingParams, so every set of every layout goes out in one call
+	if (!writeSets.empty())
+	{
+		m_Device.GetLogicDevice().updateDescriptorSets(static_cast<uint32_t>(writeSets.size()), writeSets.data(), 0, nullptr);
+	}
+}
+
+void PipeLineLayout::UpdateSet(uint32_t layoutIndex, uint32_t setIndex, const std::vector<DescriptorWriteData>& writeData)
+{
+	m_BindingParams[layoutIndex].SetWriteData[setIndex] = writeData;
+	if (m_Templates[layoutIndex])
+	{
+		UpdateWithTemplate(layoutIndex, setIndex);
+		return;
+	}
+	std::vector<vk::WriteDescriptorSet> writeSets;
+	AppendWrites(layoutIndex, setIndex, writeSets);
+	m_Device.GetLogicDevice().updateDescriptorSets(static_cast<uint32_t>(writeSets.size()), writeSets.data(), 0, nullptr);
+}
+
+void PipeLineLayout::AppendWrites(uint32_t layoutIndex, uint32_t setIndex, std::vector<vk::WriteDescriptorSet>& writeSets)
+{
+	auto& params = m_BindingParams[layoutIndex];
+	for (uint32_t k = 0; k < params.SetWriteData[setIndex].size(); k++)
+	{
+		auto& binding = params.Bindings[k];
+		auto& writeData = params.SetWriteData[setIndex][k];
+		//a partially bound array only gets the elements it was given
+		bool partial = bool(binding.Flags & vk::DescriptorBindingFlagBits::ePartiallyBound);
+		uint32_t count = writeData.ImageArray.empty() && !partial ? binding.DescriptorCount : static_cast<uint32_t>(writeData.ImageArray.size());
+		if (count == 0)
+		{
+			continue;
+		}
+		vk::WriteDescriptorSet writeSet;
+		writeSet.sType = vk::StructureType::eWriteDescriptorSet;
+		writeSet.setDescriptorCount(count)
+				.setDescriptorType(binding.Type)
+				.setDstArrayElement(0)
+				.setDstBinding(binding.Binding)
+				.setDstSet(m_DescriptorSets[layoutIndex].DescriptorSets[setIndex]);
+		if (!writeData.ImageArray.empty())
+		{
+			writeSet.setPImageInfo(writeData.ImageArray.data());
+		}
+		else if (writeData.IsImage)
+		{
+			writeSet.setPImageInfo(&writeData.ImageInfo);
+		}
+		else
+		{
+			writeSet.setPBufferInfo(&writeData.BufferInfo);
+		}
+		writeSets.push_back(writeSet);
+	}
+}
+
+void PipeLineLayout::CreateUpdateTemplate(uint32_t layoutIndex)
+{
+	auto& bindings = m_BindingParams[layoutIndex].Bindings;
+	//partially bound arrays are written with a varying count, a template always writes all of them
+	for (auto& binding : bindings)
+	{
+		if (binding.Flags & vk::DescriptorBindingFlagBits::ePartiallyBound)
+		{
+			return;
+		}
+	}
+	//one slot per descriptor, in binding order
+	std::vector<vk::DescriptorUpdateTemplateEntry> entries(bindings.size());
+	uint32_t slot = 0;
+	for (size_t k = 0; k < bindings.size(); k++)
+	{
+		entries[k].setDstBinding(bindings[k].Binding)
+				  .setDstArrayElement(0)
+				  .setDescriptorCount(bindings[k].DescriptorCount)
+				  .setDescriptorType(bindings[k].Type)
+				  .setOffset(slot * sizeof(DescriptorTemplateSlot))
+				  .setStride(sizeof(DescriptorTemplateSlot));
+		slot += bindings[k].DescriptorCount;
+	}
+	vk::DescriptorUpdateTemplateCreateInfo templateInfo;
+	templateInfo.sType = vk::StructureType::eDescriptorUpdateTemplateCreateInfo;
+	templateInfo.setDescriptorUpdateEntryCount(static_cast<uint32_t>(entries.size()))
+				.setPDescriptorUpdateEntries(entries.data())
+				.setTemplateType(vk::DescriptorUpdateTemplateType::eDescriptorSet)
+				.setDescriptorSetLayout(m_SetLayouts[layoutIndex]);
+	VK_CHECK_RESULT(m_Device.GetLogicDevice().createDescriptorUpdateTemplate(&templateInfo, nullptr, &m_Templates[layoutIndex]));
+	m_TemplateSlots[layoutIndex] = slot;
+}
 
-			uint32_t setBindingCount = m_BindingParams[i].SetWriteData[j].size();
-			std::vector< vk::WriteDescriptorSet> writeSets;
-			writeSets.resize(setBindingCount);
-			for (uint32_t k = 0; k < setBindingCount; k++)
+void PipeLineLayout::UpdateWithTemplate(uint32_t layoutIndex, uint32_t setIndex)
+{
+	auto& params = m_BindingParams[layoutIndex];
+	std::vector<DescriptorTemplateSlot> slots(m_TemplateSlots[layoutIndex]);
+	uint32_t slot = 0;
+	for (uint32_t k = 0; k < params.Bindings.size(); k++)
+	{
+		auto& writeData = params.SetWriteData[setIndex][k];
+		for (uint32_t element = 0; element < params.Bindings[k].DescriptorCount; element++)
+		{
+			if (!writeData.ImageArray.empty())
+			{
+				slots[slot + element].Image = writeData.ImageArray[(std::min)(element, static_cast<uint32_t>(writeData.ImageArray.size() - 1))];
+			}
+			else if (writeData.IsImage)
+			{
+				slots[slot + element].Image = writeData.ImageInfo;
+			}
+			else
 			{
-				auto& binding = m_BindingParams[i].Bindings[k];
-				auto& writeData = m_BindingParams[i].SetWriteData[j][k];
-				writeSets[k].sType = vk::StructureType::eWriteDescriptorSet;
-				writeSets[k].setDescriptorCount(binding.DescriptorCount)
-							.setDescriptorType(binding.Type)
-							.setDstArrayElement(0)
-							.setDstBinding(binding.Binding)
-							.setDstSet(m_DescriptorSets[i].DescriptorSets[j]);
-				if (writeData.IsImage)
-				{
-					writeSets[k].setPImageInfo(&writeData.ImageInfo);
-				}
-				else
-				{
-					writeSets[k].setPBufferInfo(&writeData.BufferInfo);
-				}
+				slots[slot + element].Buffer = writeData.BufferInfo;
 			}
-			m_Device.GetLogicDevice().updateDescriptorSets(writeSets.size(), writeSets.data(), 0, nullptr);
 		}
+		slot += params.Bindings[k].DescriptorCount;
 	}
-}
\ No newline at end of file
+	m_Device.GetLogicDevice().updateDescriptorSetWithTemplate(m_DescriptorSets[layoutIndex].DescriptorSets[setIndex], m_Templates[layoutIndex], slots.data());
+}
+
+void PipeLineLayout::WriteImage(uint32_t layoutIndex, uint32_t setIndex, uint32_t binding, uint32_t arrayElement, const vk::DescriptorImageInfo& image)
+{
+	vk::DescriptorType type = vk::DescriptorType::eCombinedImageSampler;
+	for (auto& desc : m_BindingParams[layoutIndex].Bindings)
+	{
+		if (desc.Binding == binding)
+		{
+			type = desc.Type;
+		}
+	}
+	vk::WriteDescriptorSet writeSet;
+	writeSet.sType = vk::StructureType::eWriteDescriptorSet;
+	writeSet.setDescriptorCount(1)
+			.setDescriptorType(type)
+			.setDstArrayElement(arrayElement)
+			.setDstBinding(binding)
+			.setDstSet(m_DescriptorSets[layoutIndex].DescriptorSets[setIndex])
+			.setPImageInfo(&image);
+	m_Device.GetLogicDevice().updateDescriptorSets(1, &writeSet, 0, nullptr);
+}
+
+void PipeLineLayout::Clear()
+{
+	for (auto& updateTemplate : m_Templates)
+	{
+		if (updateTemplate)
+		{
+			m_Device.GetLogicDevice().destroyDescriptorUpdateTemplate(updateTemplate, nullptr);
+		}
+	}
+	m_Templates.clear();
+	if (m_PipelineLayout)
+	{
+		m_Device.GetLogicDevice().destroyPipelineLayout(m_PipelineLayout, nullptr);
+		m_PipelineLayout = nullptr;
+	}
+}
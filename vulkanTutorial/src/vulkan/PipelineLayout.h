@@ -4,19 +4,13 @@
 #include <vector>
 #include <vulkan/vulkan.hpp>
 
-struct DescriptorBinding
-{
-	vk::DescriptorType Type;
-	vk::ShaderStageFlags ShaderStage;
-	uint32_t Binding;
-	uint32_t DescriptorCount = 1;
-};
-
 struct DescriptorWriteData
 {
 	vk::DescriptorBufferInfo BufferInfo;
 	vk::DescriptorImageInfo ImageInfo;
 	bool IsImage;
+	//fills the first elements of an image array binding, the rest stay unwritten
+	std::vector<vk::DescriptorImageInfo> ImageArray = {};
 };
 
 struct DescriptorSetLayoutCreateInfo
@@ -24,6 +18,8 @@ struct DescriptorSetLayoutCreateInfo
 	std::vector<DescriptorBinding> Bindings;	
 	uint32_t SetCount;
 	std::vector<std::vector<DescriptorWriteData>> SetWriteData;
+	//for sets rewritten often: UpdateSet goes through a vk::DescriptorUpdateTemplate built from Bindings
+	bool UseUpdateTemplate = false;
 };
 
 struct DescriptorSetLayoutSet
@@ -36,20 +32,29 @@ class PipeLineLayout
 {
 public:
 	void Create(const Device& device, const std::vector<DescriptorSetLayoutCreateInfo>& setLayouts, const std::vector<vk::PushConstantRange>& pushConsnts);
-	void BuildAndUpdateSet(vk::DescriptorPool pool);
+	//the sets come from the device's DescriptorSetManager
+	void BuildAndUpdateSet();
+	//set layouts belong to the DescriptorSetManager, only the pipeline layout is destroyed
+	void Clear();
 	std::vector<vk::DescriptorSetLayout>& GetSetLayout() { return m_SetLayouts; }
 	vk::PipelineLayout GetPipelineLayout() { return m_PipelineLayout; }
-	std::vector<vk::DescriptorPoolSize>& GetPoolSizes() { return m_PoolSizes; }
 	vk::DescriptorSet GetDescriptorSet(uint32_t layoutIndex, uint32_t setIndex = 0) { return m_DescriptorSets[layoutIndex].DescriptorSets[setIndex]; }
 	std::vector<vk::DescriptorSet>& GetDescriptorSets(uint32_t layoutIndex) { return m_DescriptorSets[layoutIndex].DescriptorSets; }
-	uint32_t GetMaxSet() { return m_SetCount; }
+	//rewrites every binding of one set, with one call through the update template when the layout has one
+	void UpdateSet(uint32_t layoutIndex, uint32_t setIndex, const std::vector<DescriptorWriteData>& writeData);
+	//writes one array element of an update after bind binding, the set may already be bound
+	void WriteImage(uint32_t layoutIndex, uint32_t setIndex, uint32_t binding, uint32_t arrayElement, const vk::DescriptorImageInfo& image);
 private:
 	Device m_Device;
 	vk::PipelineLayout m_PipelineLayout;
 	std::vector<vk::DescriptorSetLayout> m_SetLayouts;
 	std::vector<DescriptorSetLayoutSet> m_DescriptorSets;
-	std::vector<vk::DescriptorPoolSize> m_PoolSizes;
 	std::vector<DescriptorSetLayoutCreateInfo> m_BindingParams;
-	uint32_t m_SetlayoutCount;
-	uint32_t m_SetCount;
+	uint32_t m_SetlayoutCount = 0;
+	std::vector<vk::DescriptorUpdateTemplate> m_Templates;
+	std::vector<uint32_t> m_TemplateSlots;
+private:
+	void CreateUpdateTemplate(uint32_t layoutIndex);
+	void AppendWrites(uint32_t layoutIndex, uint32_t setIndex, std::vector<vk::WriteDescriptorSet>& writeSets);
+	void UpdateWithTemplate(uint32_t layoutIndex, uint32_t setIndex);
 };
\ No newline at end of file
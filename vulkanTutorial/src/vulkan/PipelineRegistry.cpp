@@ -0,0 +1,395 @@
+#include "../Core.h"
+#include "PipelineRegistry.h"
+#include "../core/Hash.h"
+#include "../core/JobSystem.h"
+#include "../../utils/readFile.h"
+#include <filesystem>
+#include <fstream>
+#include <cstring>
+
+static const uint32_t PipelineCacheMagic = 0x43504C50; //"PLPC"
+static const uint32_t PipelineCacheVersion = 1;
+
+//the driver also checks its own header, this one lets a stale cache be dropped before it is handed over
+struct PipelineCacheFileHeader
+{
+	uint32_t Magic;
+	uint32_t Version;
+	uint32_t VendorID;
+	uint32_t DeviceID;
+	uint32_t DriverVersion;
+	uint8_t CacheUUID[VK_UUID_SIZE];
+	uint64_t DataSize;
+	uint64_t DataHash;
+};
+
+uint64_t GraphicsPipelineDesc::Hash() const
+{
+	uint64_t hash = HashSeed;
+	for (auto& shader : Shaders)
+	{
+		hash = HashValue(hash, shader.Stage);
+		hash = HashBytes(hash, shader.Path.data(), shader.Path.size());
+	}
+	for (auto& binding : Bindings)
+	{
+		hash = HashValue(hash, binding.binding);
+		hash = HashValue(hash, binding.stride);
+		hash = HashValue(hash, binding.inputRate);
+	}
+	for (auto& attribute : Attributes)
+	{
+		hash = HashValue(hash, attribute.location);
+		hash = HashValue(hash, attribute.binding);
+		hash = HashValue(hash, attribute.format);
+		hash = HashValue(hash, attribute.offset);
+	}
+	hash = HashValue(hash, Topology);
+	hash = HashValue(hash, PolygonMode);
+	hash = HashValue(hash, static_cast<VkCullModeFlags>(CullMode));
+	hash = HashValue(hash, FrontFace);
+	hash = HashValue(hash, DepthTest);
+	hash = HashValue(hash, DepthWrite);
+	hash = HashValue(hash, DepthCompareOp);
+	hash = HashValue(hash, Samples);
+	hash = HashValue(hash, BlendEnable);
+	hash = HashValue(hash, ColorAttachmentCount);
+	hash = HashValue(hash, static_cast<VkPipelineLayout>(Layout));
+	hash = HashValue(hash, static_cast<VkRenderPass>(RenderPass));
+	hash = HashValue(hash, Subpass);
+	for (auto format : ColorFormats)
+	{
+		hash = HashValue(hash, format);
+	}
+	hash = HashValue(hash, DepthFormat);
+	return hash;
+}
+
+void PipelineRegistry::Create(vk::Device device, const vk::PhysicalDeviceProperties& properties, const std::string& cachePath)
+{
+	m_Device = device;
+	m_Properties = properties;
+	m_CachePath = cachePath;
+	std::vector<char> data = LoadCacheData();
+	m_Stats.CacheLoaded = !data.empty();
+
+	vk::PipelineCacheCreateInfo cacheInfo;
+	cacheInfo.sType = vk::StructureType::ePipelineCacheCreateInfo;
+	cacheInfo.setInitialDataSize(data.size())
+			 .setPInitialData(data.empty() ? nullptr : data.data());
+	VK_CHECK_RESULT(m_Device.createPipelineCache(&cacheInfo, nullptr, &m_Cache));
+}
+
+vk::Pipeline PipelineRegistry::GetPipeline(const GraphicsPipelineDesc& desc)
+{
+	return GetPipelines({ desc })[0];
+}
+
+std::vector<vk::Pipeline> PipelineRegistry::GetPipelines(const std::vector<GraphicsPipelineDesc>& descs)
+{
+	std::vector<vk::Pipeline> result(descs.size());
+	std::vector<uint64_t> hashes(descs.size());
+	//index of the first request in this batch with the same state, so duplicates are created once
+	std::vector<size_t> missing;
+	std::vector<size_t> sources(descs.size());
+	for (size_t i = 0; i < descs.size(); i++)
+	{
+		m_Stats.Requests++;
+		hashes[i] = descs[i].Hash();
+		sources[i] = i;
+		result[i] = Find(descs[i], hashes[i]);
+		if (result[i])
+		{
+			m_Stats.Hits++;
+			continue;
+		}
+		for (size_t j : missing)
+		{
+			if (hashes[j] == hashes[i] && descs[j] == descs[i])
+			{
+				sources[i] = j;
+				m_Stats.Hits++;
+				break;
+			}
+		}
+		if (sources[i] == i)
+		{
+			missing.push_back(i);
+			//modules are loaded up front, the jobs only read the map
+			for (auto& shader : descs[i].Shaders)
+			{
+				LoadShader(shader.Path);
+			}
+		}
+	}
+
+	//the pipeline cache is internally synchronized, creation can run on any thread
+	JobCounter counter;
+	for (size_t i : missing)
+	{
+		JobSystem::Get().Submit([this, i, &descs, &result]() {
+			result[i] = CreatePipeline(descs[i]);
+		}, &counter);
+	}
+	JobSystem::Get().Wait(counter);
+
+	for (size_t i : missing)
+	{
+		m_Pipelines.insert({ hashes[i], { descs[i], result[i] } });
+		m_Stats.Created++;
+	}
+	for (size_t i = 0; i < descs.size(); i++)
+	{
+		result[i] = result[sources[i]];
+	}
+	return result;
+}
+
+vk::Pipeline PipelineRegistry::GetComputePipeline(const std::string& path, vk::PipelineLayout layout)
+{
+	m_Stats.Requests++;
+	for (auto& entry : m_ComputePipelines)
+	{
+		if (entry.Path == path && entry.Layout == layout)
+		{
+			m_Stats.Hits++;
+			return entry.Pipeline;
+		}
+	}
+	vk::PipelineShaderStageCreateInfo shader;
+	shader.sType = vk::StructureType::ePipelineShaderStageCreateInfo;
+	shader.setModule(LoadShader(path))
+		  .setPName("main")
+		  .setStage(vk::ShaderStageFlagBits::eCompute);
+	vk::ComputePipelineCreateInfo pipelineInfo;
+	pipelineInfo.sType = vk::StructureType::eComputePipelineCreateInfo;
+	pipelineInfo.setStage(shader)
+				.setLayout(layout)
+				.setBasePipelineHandle(VK_NULL_HANDLE)
+				.setBasePipelineIndex(-1);
+	vk::Pipeline pipeline;
+	VK_CHECK_RESULT(m_Device.createComputePipelines(m_Cache, 1, &pipelineInfo, nullptr, &pipeline));
+	m_ComputePipelines.push_back({ path, layout, pipeline });
+	m_Stats.Created++;
+	return pipeline;
+}
+
+vk::Pipeline PipelineRegistry::Find(const GraphicsPipelineDesc& desc, uint64_t hash)
+{
+	auto range = m_Pipelines.equal_range(hash);
+	for (auto it = range.first; it != range.second; it++)
+	{
+		if (it->second.Desc == desc)
+		{
+			return it->second.Pipeline;
+		}
+	}
+	return nullptr;
+}
+
+vk::ShaderModule PipelineRegistry::LoadShader(const std::string& path)
+{
+	auto it = m_Shaders.find(path);
+	if (it != m_Shaders.end())
+	{
+		return it->second;
+	}
+	auto shaderCode = ReadFile(path);
+	vk::ShaderModuleCreateInfo shaderInfo;
+	shaderInfo.sType = vk::StructureType::eShaderModuleCreateInfo;
+	shaderInfo.setCodeSize(shaderCode.size())
+			  .setPCode(reinterpret_cast<const uint32_t*>(shaderCode.data()));
+	vk::ShaderModule module;
+	VK_CHECK_RESULT(m_Device.createShaderModule(&shaderInfo, nullptr, &module));
+	m_Shaders[path] = module;
+	return module;
+}
+
+vk::Pipeline PipelineRegistry::CreatePipeline(const GraphicsPipelineDesc& desc)
+{
+	vk::PipelineVertexInputStateCreateInfo vertexInput;
+	vertexInput.sType = vk::StructureType::ePipelineVertexInputStateCreateInfo;
+	vertexInput.setVertexBindingDescriptionCount(static_cast<uint32_t>(desc.Bindings.size())).setPVertexBindingDescriptions(desc.Bindings.data())
+			   .setVertexAttributeDescriptionCount(static_cast<uint32_t>(desc.Attributes.size())).setPVertexAttributeDescriptions(desc.Attributes.data());
+
+	vk::PipelineInputAssemblyStateCreateInfo assemblyInfo;
+	assemblyInfo.sType = vk::StructureType::ePipelineInputAssemblyStateCreateInfo;
+	assemblyInfo.setTopology(desc.Topology)
+				.setPrimitiveRestartEnable(VK_FALSE);
+
+	std::vector<vk::PipelineShaderStageCreateInfo> shaders(desc.Shaders.size());
+	for (size_t i = 0; i < desc.Shaders.size(); i++)
+	{
+		shaders[i].sType = vk::StructureType::ePipelineShaderStageCreateInfo;
+		shaders[i].setModule(m_Shaders.at(desc.Shaders[i].Path))
+				  .setPName("main")
+				  .setStage(desc.Shaders[i].Stage);
+	}
+
+	vk::PipelineRasterizationStateCreateInfo rasterizationInfo;
+	rasterizationInfo.sType = vk::StructureType::ePipelineRasterizationStateCreateInfo;
+	rasterizationInfo.setCullMode(desc.CullMode)
+					 .setDepthBiasEnable(VK_FALSE)
+					 .setDepthClampEnable(VK_FALSE)
+					 .setFrontFace(desc.FrontFace)
+					 .setLineWidth(1.0f)
+					 .setPolygonMode(desc.PolygonMode)
+					 .setRasterizerDiscardEnable(VK_FALSE);
+
+	vk::PipelineColorBlendAttachmentState attachment;
+	attachment.setBlendEnable(desc.BlendEnable)
+			  .setSrcColorBlendFactor(vk::BlendFactor::eSrcAlpha)
+			  .setDstColorBlendFactor(vk::BlendFactor::eOneMinusSrcAlpha)
+			  .setColorBlendOp(vk::BlendOp::eAdd)
+			  .setSrcAlphaBlendFactor(vk::BlendFactor::eOne)
+			  .setDstAlphaBlendFactor(vk::BlendFactor::eZero)
+			  .setAlphaBlendOp(vk::BlendOp::eAdd)
+			  .setColorWriteMask(vk::ColorComponentFlagBits::eR | vk::ColorComponentFlagBits::eG | vk::ColorComponentFlagBits::eB | vk::ColorComponentFlagBits::eA);
+	std::vector<vk::PipelineColorBlendAttachmentState> attachments(desc.ColorAttachmentCount, attachment);
+	vk::PipelineColorBlendStateCreateInfo blendingInfo;
+	blendingInfo.sType = vk::StructureType::ePipelineColorBlendStateCreateInfo;
+	blendingInfo.setAttachmentCount(static_cast<uint32_t>(attachments.size()))
+				.setPAttachments(attachments.data())
+				.setLogicOpEnable(VK_FALSE);
+
+	vk::PipelineDepthStencilStateCreateInfo depthStencilInfo;
+	depthStencilInfo.sType = vk::StructureType::ePipelineDepthStencilStateCreateInfo;
+	depthStencilInfo.setDepthTestEnable(desc.DepthTest)
+					.setDepthWriteEnable(desc.DepthWrite)
+					.setDepthCompareOp(desc.DepthCompareOp)
+					.setDepthBoundsTestEnable(VK_FALSE)
+					.setMaxDepthBounds(1.0f)
+					.setMinDepthBounds(0.0f)
+					.setStencilTestEnable(VK_FALSE);
+
+	vk::PipelineViewportStateCreateInfo viewportInfo;
+	viewportInfo.sType = vk::StructureType::ePipelineViewportStateCreateInfo;
+	viewportInfo.setViewportCount(1)
+				.setScissorCount(1);
+
+	std::vector<vk::DynamicState> dynamicStates = { vk::DynamicState::eViewport, vk::DynamicState::eScissor };
+	vk::PipelineDynamicStateCreateInfo dynamicState;
+	dynamicState.sType = vk::StructureType::ePipelineDynamicStateCreateInfo;
+	dynamicState.setDynamicStateCount(static_cast<uint32_t>(dynamicStates.size()))
+				.setPDynamicStates(dynamicStates.data());
+
+	vk::PipelineMultisampleStateCreateInfo multisamplesInfo;
+	multisamplesInfo.sType = vk::StructureType::ePipelineMultisampleStateCreateInfo;
+	multisamplesInfo.setRasterizationSamples(desc.Samples)
+					.setSampleShadingEnable(VK_FALSE)
+					.setAlphaToCoverageEnable(VK_FALSE)
+					.setAlphaToOneEnable(VK_FALSE);
+
+	//without a render pass the attachment formats come from the desc
+	vk::PipelineRenderingCreateInfo renderingInfo;
+	renderingInfo.sType = vk::StructureType::ePipelineRenderingCreateInfo;
+	bool stencil = desc.DepthFormat == vk::Format::eD32SfloatS8Uint || desc.DepthFormat == vk::Format::eD24UnormS8Uint || desc.DepthFormat == vk::Format::eD16UnormS8Uint;
+	renderingInfo.setColorAttachmentCount(static_cast<uint32_t>(desc.ColorFormats.size()))
+				 .setPColorAttachmentFormats(desc.ColorFormats.data())
+				 .setDepthAttachmentFormat(desc.DepthFormat)
+				 .setStencilAttachmentFormat(stencil ? desc.DepthFormat : vk::Format::eUndefined);
+
+	vk::GraphicsPipelineCreateInfo pipelineInfo;
+	pipelineInfo.sType = vk::StructureType::eGraphicsPipelineCreateInfo;
+	pipelineInfo.setPVertexInputState(&vertexInput)
+				.setPInputAssemblyState(&assemblyInfo)
+				.setStageCount(static_cast<uint32_t>(shaders.size()))
+				.setPStages(shaders.data())
+				.setPRasterizationState(&rasterizationInfo)
+				.setPViewportState(&viewportInfo)
+				.setPColorBlendState(&blendingInfo)
+				.setPDepthStencilState(&depthStencilInfo)
+				.setPMultisampleState(&multisamplesInfo)
+				.setLayout(desc.Layout)
+				.setRenderPass(desc.RenderPass)
+				.setSubpass(desc.Subpass)
+				.setPDynamicState(&dynamicState)
+				.setBasePipelineHandle(VK_NULL_HANDLE)
+				.setBasePipelineIndex(-1)
+				.setPNext(desc.RenderPass ? nullptr : &renderingInfo);
+	vk::Pipeline pipeline;
+	VK_CHECK_RESULT(m_Device.createGraphicsPipelines(m_Cache, 1, &pipelineInfo, nullptr, &pipeline));
+	return pipeline;
+}
+
+std::vector<char> PipelineRegistry::LoadCacheData()
+{
+	std::ifstream file(m_CachePath, std::ios::binary);
+	PipelineCacheFileHeader header;
+	if (!file.is_open() || !file.read(reinterpret_cast<char*>(&header), sizeof(header)))
+	{
+		return {};
+	}
+	if (header.Magic != PipelineCacheMagic || header.Version != PipelineCacheVersion
+		|| header.VendorID != m_Properties.vendorID || header.DeviceID != m_Properties.deviceID
+		|| header.DriverVersion != m_Properties.driverVersion
+		|| memcmp(header.CacheUUID, m_Properties.pipelineCacheUUID.data(), VK_UUID_SIZE) != 0)
+	{
+		return {};
+	}
+	std::vector<char> data(static_cast<size_t>(header.DataSize));
+	if (!file.read(data.data(), data.size()) || HashBytes(HashSeed, data.data(), data.size()) != header.DataHash)
+	{
+		return {};
+	}
+	return data;
+}
+
+void PipelineRegistry::Save()
+{
+	size_t size = 0;
+	VK_CHECK_RESULT(m_Device.getPipelineCacheData(m_Cache, &size, nullptr));
+	std::vector<char> data(size);
+	VK_CHECK_RESULT(m_Device.getPipelineCacheData(m_Cache, &size, data.data()));
+	data.resize(size);
+
+	PipelineCacheFileHeader header = {};
+	header.Magic = PipelineCacheMagic;
+	header.Version = PipelineCacheVersion;
+	header.VendorID = m_Properties.vendorID;
+	header.DeviceID = m_Properties.deviceID;
+	header.DriverVersion = m_Properties.driverVersion;
+	memcpy(header.CacheUUID, m_Properties.pipelineCacheUUID.data(), VK_UUID_SIZE);
+	header.DataSize = data.size();
+	header.DataHash = HashBytes(HashSeed, data.data(), data.size());
+
+	//write aside and rename so an interrupted save never leaves a truncated cache
+	std::string tempPath = m_CachePath + ".tmp";
+	{
+		std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+		if (!file.write(reinterpret_cast<const char*>(&header), sizeof(header)) || !file.write(data.data(), data.size()))
+		{
+			return;
+		}
+	}
+	std::error_code error;
+	std::filesystem::rename(tempPath, m_CachePath, error);
+	if (error)
+	{
+		std::filesystem::remove(tempPath, error);
+	}
+}
+
+void PipelineRegistry::Clear()
+{
+	if (m_Stats.Created > 0)
+	{
+		Save();
+	}
+	for (auto& [hash, entry] : m_Pipelines)
+	{
+		m_Device.destroyPipeline(entry.Pipeline, nullptr);
+	}
+	m_Pipelines.clear();
+	for (auto& entry : m_ComputePipelines)
+	{
+		m_Device.destroyPipeline(entry.Pipeline, nullptr);
+	}
+	m_ComputePipelines.clear();
+	for (auto& [path, module] : m_Shaders)
+	{
+		m_Device.destroyShaderModule(module, nullptr);
+	}
+	m_Shaders.clear();
+	m_Device.destroyPipelineCache(m_Cache, nullptr);
+}
@@ -0,0 +1,85 @@
+#pragma once
+#include <vulkan/vulkan.hpp>
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+struct PipelineShaderDesc
+{
+	vk::ShaderStageFlagBits Stage;
+	std::string Path;
+	bool operator==(const PipelineShaderDesc& other) const = default;
+};
+
+//full state of a graphics pipeline, viewport and scissor are always dynamic
+struct GraphicsPipelineDesc
+{
+	std::vector<PipelineShaderDesc> Shaders;
+	std::vector<vk::VertexInputBindingDescription> Bindings;
+	std::vector<vk::VertexInputAttributeDescription> Attributes;
+	vk::PrimitiveTopology Topology = vk::PrimitiveTopology::eTriangleList;
+	vk::PolygonMode PolygonMode = vk::PolygonMode::eFill;
+	vk::CullModeFlags CullMode = vk::CullModeFlagBits::eBack;
+	vk::FrontFace FrontFace = vk::FrontFace::eCounterClockwise;
+	bool DepthTest = true;
+	bool DepthWrite = true;
+	vk::CompareOp DepthCompareOp = vk::CompareOp::eLessOrEqual;
+	vk::SampleCountFlagBits Samples = vk::SampleCountFlagBits::e1;
+	bool BlendEnable = false;
+	uint32_t ColorAttachmentCount = 1;
+	vk::PipelineLayout Layout;
+	vk::RenderPass RenderPass;
+	uint32_t Subpass = 0;
+	//attachment formats for dynamic rendering, only used when RenderPass is null
+	std::vector<vk::Format> ColorFormats;
+	vk::Format DepthFormat = vk::Format::eUndefined;
+	bool operator==(const GraphicsPipelineDesc& other) const = default;
+	uint64_t Hash() const;
+};
+
+struct PipelineRegistryStats
+{
+	uint32_t Requests = 0;
+	uint32_t Hits = 0;
+	uint32_t Created = 0;
+	bool CacheLoaded = false;
+};
+
+//dedups pipelines by their full state and backs creation with a vk::PipelineCache persisted on disk
+class PipelineRegistry
+{
+public:
+	void Create(vk::Device device, const vk::PhysicalDeviceProperties& properties, const std::string& cachePath = "pipeline_cache.bin");
+	vk::Pipeline GetPipeline(const GraphicsPipelineDesc& desc);
+	//pipelines missing from the registry are created in parallel on the job system
+	std::vector<vk::Pipeline> GetPipelines(const std::vector<GraphicsPipelineDesc>& descs);
+	vk::Pipeline GetComputePipeline(const std::string& path, vk::PipelineLayout layout);
+	const PipelineRegistryStats& GetStats() const { return m_Stats; }
+	void Save();
+	void Clear();
+private:
+	struct Entry
+	{
+		GraphicsPipelineDesc Desc;
+		vk::Pipeline Pipeline;
+	};
+	struct ComputeEntry
+	{
+		std::string Path;
+		vk::PipelineLayout Layout;
+		vk::Pipeline Pipeline;
+	};
+	vk::Pipeline Find(const GraphicsPipelineDesc& desc, uint64_t hash);
+	vk::ShaderModule LoadShader(const std::string& path);
+	vk::Pipeline CreatePipeline(const GraphicsPipelineDesc& desc);
+	std::vector<char> LoadCacheData();
+private:
+	vk::Device m_Device;
+	vk::PhysicalDeviceProperties m_Properties;
+	std::string m_CachePath;
+	vk::PipelineCache m_Cache;
+	std::unordered_multimap<uint64_t, Entry> m_Pipelines;
+	std::vector<ComputeEntry> m_ComputePipelines;
+	std::unordered_map<std::string, vk::ShaderModule> m_Shaders;
+	PipelineRegistryStats m_Stats;
+};
@@ -0,0 +1,266 @@
+#include "../Core.h"
+#include "Profiler.h"
+#include "json.hpp"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+
+void Profiler::Create(vk::Device device, vk::PhysicalDevice physicalDevice, uint32_t queueFamilyIndex, uint32_t framesInFlight, uint32_t maxGpuScopes, uint32_t historySize)
+{
+	m_Device = device;
+	m_MaxGpuScopes = maxGpuScopes;
+	m_HistorySize = historySize;
+	m_FrameScopes.assign(framesInFlight, {});
+	m_LastFrame = std::chrono::high_resolution_clock::now();
+
+	auto properties = physicalDevice.getProperties();
+	auto queueFamilies = physicalDevice.getQueueFamilyProperties();
+	uint32_t validBits = queueFamilies[queueFamilyIndex].timestampValidBits;
+	if (validBits == 0 || properties.limits.timestampPeriod == 0.0f)
+	{
+		std::cout << "gpu timestamps not supported, only cpu timers are recorded" << std::endl;
+		return;
+	}
+	m_TimestampPeriod = properties.limits.timestampPeriod;
+	m_TimestampMask = validBits >= 64 ? ~0ull : ((1ull << validBits) - 1);
+
+	vk::QueryPoolCreateInfo poolInfo;
+	poolInfo.sType = vk::StructureType::eQueryPoolCreateInfo;
+	poolInfo.setQueryType(vk::QueryType::eTimestamp)
+			.setQueryCount(framesInFlight * maxGpuScopes * 2);
+	VK_CHECK_RESULT(m_Device.createQueryPool(&poolInfo, nullptr, &m_QueryPool));
+}
+
+void Profiler::NewFrame(uint32_t frameIndex)
+{
+	auto now = std::chrono::high_resolution_clock::now();
+	std::chrono::duration<double, std::milli> frameTime = now - m_LastFrame;
+	m_LastFrame = now;
+	if (m_FrameCount > 0)
+	{
+		AddCpuSample("frame", frameTime.count());
+	}
+	m_FrameCount++;
+
+	m_FrameIndex = frameIndex;
+	if (m_QueryPool)
+	{
+		ResolveFrame(frameIndex);
+	}
+	if (m_DumpInterval > 0 && m_FrameCount % m_DumpInterval == 0)
+	{
+		Dump(m_DumpPath);
+	}
+}
+
+void Profiler::ResetQueries(vk::CommandBuffer command)
+{
+	if (!m_QueryPool)
+	{
+		return;
+	}
+	m_FrameScopes[m_FrameIndex].clear();
+	m_OpenScopes.clear();
+	command.resetQueryPool(m_QueryPool, m_FrameIndex * m_MaxGpuScopes * 2, m_MaxGpuScopes * 2);
+}
+
+void Profiler::BeginGpu(vk::CommandBuffer command, const std::string& name)
+{
+	if (!m_QueryPool || m_FrameScopes[m_FrameIndex].size() >= m_MaxGpuScopes)
+	{
+		//keep begin/end balanced even when the scope is not recorded
+		m_OpenScopes.push_back(UINT32_MAX);
+		return;
+	}
+	auto& scopes = m_FrameScopes[m_FrameIndex];
+	GpuScope scope;
+	scope.SeriesIndex = GetSeries(name, true);
+	scope.Query = (m_FrameIndex * m_MaxGpuScopes + static_cast<uint32_t>(scopes.size())) * 2;
+	command.writeTimestamp(vk::PipelineStageFlagBits::eTopOfPipe, m_QueryPool, scope.Query);
+	m_OpenScopes.push_back(static_cast<uint32_t>(scopes.size()));
+	scopes.push_back(scope);
+}
+
+void Profiler::EndGpu(vk::CommandBuffer command)
+{
+	if (m_OpenScopes.empty())
+	{
+		return;
+	}
+	uint32_t scopeIndex = m_OpenScopes.back();
+	m_OpenScopes.pop_back();
+	if (scopeIndex == UINT32_MAX)
+	{
+		return;
+	}
+	command.writeTimestamp(vk::PipelineStageFlagBits::eBottomOfPipe, m_QueryPool, m_FrameScopes[m_FrameIndex][scopeIndex].Query + 1);
+}
+
+void Profiler::ResolveFrame(uint32_t frameIndex)
+{
+	auto& scopes = m_FrameScopes[frameIndex];
+	if (scopes.empty())
+	{
+		return;
+	}
+	//the slot's fence has already been waited on, so the results are normally ready and this never blocks
+	uint32_t first = frameIndex * m_MaxGpuScopes * 2;
+	uint32_t count = static_cast<uint32_t>(scopes.size()) * 2;
+	std::vector<uint64_t> timestamps(count);
+	vk::Result result = m_Device.getQueryPoolResults(m_QueryPool, first, count, timestamps.size() * sizeof(uint64_t), timestamps.data(), sizeof(uint64_t), vk::QueryResultFlagBits::e64);
+	if (result == vk::Result::eSuccess)
+	{
+		for (auto& scope : scopes)
+		{
+			uint64_t begin = timestamps[scope.Query - first];
+			uint64_t end = timestamps[scope.Query - first + 1];
+			uint64_t ticks = (end - begin) & m_TimestampMask;
+			AddSample(scope.SeriesIndex, ticks * m_TimestampPeriod / 1000000.0);
+		}
+	}
+	scopes.clear();
+}
+
+void Profiler::AddCpuSample(const std::string& name, double milliseconds)
+{
+	AddSample(GetSeries(name, false), milliseconds);
+}
+
+uint32_t Profiler::GetSeries(const std::string& name, bool gpu)
+{
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	auto& indices = m_SeriesIndices[gpu ? 1 : 0];
+	auto it = indices.find(name);
+	if (it != indices.end())
+	{
+		return it->second;
+	}
+	uint32_t index = static_cast<uint32_t>(m_Series.size());
+	Series series;
+	series.Name = name;
+	series.Gpu = gpu;
+	series.Samples.reserve(m_HistorySize);
+	m_Series.push_back(std::move(series));
+	indices[name] = index;
+	return index;
+}
+
+void Profiler::AddSample(uint32_t seriesIndex, double milliseconds)
+{
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	Series& series = m_Series[seriesIndex];
+	if (series.Samples.size() < m_HistorySize)
+	{
+		series.Samples.push_back(milliseconds);
+	}
+	else
+	{
+		series.Samples[series.Next] = milliseconds;
+	}
+	series.Next = (series.Next + 1) % m_HistorySize;
+}
+
+std::vector<ProfileStats> Profiler::GetStats()
+{
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	std::vector<ProfileStats> result;
+	for (auto& series : m_Series)
+	{
+		if (series.Samples.empty())
+		{
+			continue;
+		}
+		ProfileStats stats;
+		stats.Name = series.Name;
+		stats.Gpu = series.Gpu;
+		stats.Count = static_cast<uint32_t>(series.Samples.size());
+		stats.Last = series.Samples[(series.Next + m_HistorySize - 1) % m_HistorySize];
+		std::vector<double> sorted = series.Samples;
+		std::sort(sorted.begin(), sorted.end());
+		double sum = 0.0;
+		for (double sample : sorted)
+		{
+			sum += sample;
+		}
+		stats.Min = sorted.front();
+		stats.Avg = sum / sorted.size();
+		size_t p99 = static_cast<size_t>(std::ceil(sorted.size() * 0.99)) - 1;
+		stats.P99 = sorted[p99];
+		result.push_back(stats);
+	}
+	return result;
+}
+
+void Profiler::SetDump(const std::string& path, uint32_t intervalFrames)
+{
+	m_DumpPath = path;
+	m_DumpInterval = intervalFrames;
+}
+
+bool Profiler::Dump(const std::string& path)
+{
+	if (path.empty())
+	{
+		return false;
+	}
+	std::vector<ProfileStats> stats = GetStats();
+	if (path.size() >= 5 && path.compare(path.size() - 5, 5, ".json") == 0)
+	{
+		return WriteJSON(path, stats);
+	}
+	return WriteCSV(path, stats);
+}
+
+bool Profiler::WriteCSV(const std::string& path, const std::vector<ProfileStats>& stats)
+{
+	std::ofstream file(path, std::ios::trunc);
+	if (!file.is_open())
+	{
+		std::cout << "failed to open " << path << std::endl;
+		return false;
+	}
+	file << "name,timeline,count,last_ms,min_ms,avg_ms,p99_ms\n";
+	for (auto& entry : stats)
+	{
+		file << entry.Name << "," << (entry.Gpu ? "gpu" : "cpu") << "," << entry.Count << "," << entry.Last << "," << entry.Min << "," << entry.Avg << "," << entry.P99 << "\n";
+	}
+	return true;
+}
+
+bool Profiler::WriteJSON(const std::string& path, const std::vector<ProfileStats>& stats)
+{
+	std::ofstream file(path, std::ios::trunc);
+	if (!file.is_open())
+	{
+		std::cout << "failed to open " << path << std::endl;
+		return false;
+	}
+	nlohmann::json root;
+	root["frames"] = m_FrameCount;
+	root["scopes"] = nlohmann::json::array();
+	for (auto& entry : stats)
+	{
+		root["scopes"].push_back({
+			{ "name", entry.Name },
+			{ "timeline", entry.Gpu ? "gpu" : "cpu" },
+			{ "count", entry.Count },
+			{ "last_ms", entry.Last },
+			{ "min_ms", entry.Min },
+			{ "avg_ms", entry.Avg },
+			{ "p99_ms", entry.P99 }
+		});
+	}
+	file << root.dump(4);
+	return true;
+}
+
+void Profiler::Clear()
+{
+	if (m_QueryPool)
+	{
+		m_Device.destroyQueryPool(m_QueryPool, nullptr);
+		m_QueryPool = nullptr;
+	}
+	m_FrameScopes.clear();
+	m_OpenScopes.clear();
+}
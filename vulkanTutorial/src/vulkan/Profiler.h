@@ -0,0 +1,87 @@
+#pragma once
+#include <vulkan/vulkan.hpp>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+struct ProfileStats
+{
+	std::string Name;
+	bool Gpu = false;
+	uint32_t Count = 0;
+	double Last = 0.0;
+	double Min = 0.0;
+	double Avg = 0.0;
+	double P99 = 0.0;
+};
+
+//cpu scoped timers plus gpu timestamp pairs per frame slot, a slot's gpu results are read once its fence has been waited on
+class Profiler
+{
+public:
+	void Create(vk::Device device, vk::PhysicalDevice physicalDevice, uint32_t queueFamilyIndex, uint32_t framesInFlight, uint32_t maxGpuScopes = 64, uint32_t historySize = 1024);
+	void NewFrame(uint32_t frameIndex);
+	void ResetQueries(vk::CommandBuffer command);
+	void BeginGpu(vk::CommandBuffer command, const std::string& name);
+	void EndGpu(vk::CommandBuffer command);
+	void AddCpuSample(const std::string& name, double milliseconds);
+	std::vector<ProfileStats> GetStats();
+	void SetDump(const std::string& path, uint32_t intervalFrames);
+	bool Dump(const std::string& path);
+	bool HasGpuTimestamps() const { return static_cast<bool>(m_QueryPool); }
+	uint64_t GetFrameCount() const { return m_FrameCount; }
+	void Clear();
+private:
+	struct Series
+	{
+		std::string Name;
+		bool Gpu = false;
+		std::vector<double> Samples;
+		uint32_t Next = 0;
+	};
+	struct GpuScope
+	{
+		uint32_t SeriesIndex;
+		uint32_t Query;
+	};
+	uint32_t GetSeries(const std::string& name, bool gpu);
+	void AddSample(uint32_t seriesIndex, double milliseconds);
+	void ResolveFrame(uint32_t frameIndex);
+	bool WriteCSV(const std::string& path, const std::vector<ProfileStats>& stats);
+	bool WriteJSON(const std::string& path, const std::vector<ProfileStats>& stats);
+private:
+	vk::Device m_Device;
+	vk::QueryPool m_QueryPool;
+	double m_TimestampPeriod = 1.0;
+	uint64_t m_TimestampMask = ~0ull;
+	uint32_t m_MaxGpuScopes = 0;
+	uint32_t m_HistorySize = 1024;
+	uint32_t m_FrameIndex = 0;
+	uint64_t m_FrameCount = 0;
+	std::vector<std::vector<GpuScope>> m_FrameScopes;
+	std::vector<uint32_t> m_OpenScopes;
+	std::vector<Series> m_Series;
+	std::unordered_map<std::string, uint32_t> m_SeriesIndices[2];
+	std::chrono::high_resolution_clock::time_point m_LastFrame;
+	std::string m_DumpPath;
+	uint32_t m_DumpInterval = 0;
+	std::mutex m_Mutex;
+};
+
+//adds the elapsed cpu time of the enclosing block to the named series
+class ProfileScope
+{
+public:
+	ProfileScope(Profiler& profiler, const char* name) : m_Profiler(profiler), m_Name(name), m_Start(std::chrono::high_resolution_clock::now()) {}
+	~ProfileScope()
+	{
+		std::chrono::duration<double, std::milli> elapsed = std::chrono::high_resolution_clock::now() - m_Start;
+		m_Profiler.AddCpuSample(m_Name, elapsed.count());
+	}
+private:
+	Profiler& m_Profiler;
+	const char* m_Name;
+	std::chrono::high_resolution_clock::time_point m_Start;
+};
@@ -0,0 +1,793 @@
+#include "../Core.h"
+#include "RenderGraph.h"
+#include <algorithm>
+
+RenderGraphPass& RenderGraphPass::WriteColor(RenderGraphResource resource, bool clear, vk::ClearColorValue value)
+{
+	Access access{ resource, AccessType::Color, clear };
+	access.ClearValue.color = value;
+	m_Accesses.push_back(access);
+	return *this;
+}
+
+RenderGraphPass& RenderGraphPass::WriteDepth(RenderGraphResource resource, bool clear, vk::ClearDepthStencilValue value)
+{
+	Access access{ resource, AccessType::Depth, clear };
+	access.ClearValue.depthStencil = value;
+	m_Accesses.push_back(access);
+	return *this;
+}
+
+RenderGraphPass& RenderGraphPass::ResolveColor(RenderGraphResource resource)
+{
+	m_Accesses.push_back({ resource, AccessType::Resolve });
+	return *this;
+}
+
+RenderGraphPass& RenderGraphPass::ReadTexture(RenderGraphResource resource, vk::PipelineStageFlags stages)
+{
+	Access access{ resource, AccessType::Sampled };
+	access.Stages = stages;
+	m_Accesses.push_back(access);
+	return *this;
+}
+
+void RenderGraph::Create(Device& device)
+{
+	m_Device = device;
+}
+
+RenderGraphResource RenderGraph::CreateImage(const std::string& name, const RenderGraphImageDesc& desc)
+{
+	Resource resource;
+	resource.Name = name;
+	resource.Desc = desc;
+	m_Resources.push_back(resource);
+	return static_cast<RenderGraphResource>(m_Resources.size() - 1);
+}
+
+RenderGraphResource RenderGraph::ImportImages(const std::string& name, std::vector<Image>& images, vk::Format format, vk::ImageLayout initialLayout, vk::ImageLayout finalLayout)
+{
+	Resource resource;
+	resource.Name = name;
+	resource.Desc.Format = format;
+	resource.Imported = &images;
+	resource.InitialLayout = initialLayout;
+	resource.FinalLayout = finalLayout;
+	resource.Output = true;
+	m_Resources.push_back(resource);
+	return static_cast<RenderGraphResource>(m_Resources.size() - 1);
+}
+
+void RenderGraph::SetOutput(RenderGraphResource resource)
+{
+	m_Resources[resource].Output = true;
+}
+
+RenderGraphPass& RenderGraph::AddPass(const std::string& name)
+{
+	m_Passes.emplace_back();
+	m_Passes.back().m_Name = name;
+	return m_Passes.back();
+}
+
+RenderGraph::AccessState RenderGraph::GetAccessState(const RenderGraphPass::Access& access)
+{
+	switch (access.Type)
+	{
+	case RenderGraphPass::AccessType::Color:
+		return { vk::ImageLayout::eColorAttachmentOptimal, vk::PipelineStageFlagBits::eColorAttachmentOutput,
+				 access.Clear ? vk::AccessFlags(vk::AccessFlagBits::eColorAttachmentWrite) : vk::AccessFlagBits::eColorAttachmentWrite | vk::AccessFlagBits::eColorAttachmentRead, true };
+	case RenderGraphPass::AccessType::Resolve:
+		return { vk::ImageLayout::eColorAttachmentOptimal, vk::PipelineStageFlagBits::eColorAttachmentOutput, vk::AccessFlagBits::eColorAttachmentWrite, true };
+	case RenderGraphPass::AccessType::Depth:
+		return { vk::ImageLayout::eDepthStencilAttachmentOptimal, vk::PipelineStageFlagBits::eEarlyFragmentTests | vk::PipelineStageFlagBits::eLateFragmentTests,
+				 vk::AccessFlagBits::eDepthStencilAttachmentRead | vk::AccessFlagBits::eDepthStencilAttachmentWrite, true };
+	default:
+		return { vk::ImageLayout::eShaderReadOnlyOptimal, access.Stages, vk::AccessFlagBits::eShaderRead, false };
+	}
+}
+
+void RenderGraph::Compile(vk::Extent2D extent)
+{
+	m_Extent = extent;
+	CullPasses();
+	ComputeLifetimes();
+	BuildRenderPasses();
+	BuildBarriers();
+	BuildResources();
+	m_Compiled = true;
+}
+
+void RenderGraph::Resize(vk::Extent2D extent)
+{
+	if (!m_Compiled)
+	{
+		return;
+	}
+	//frames still in flight reference the old images and framebuffers, they are destroyed once those have finished
+	m_Extent = extent;
+	m_Device.GetDeletionQueue().Release(TakeResources());
+	BuildResources();
+}
+
+void RenderGraph::CullPasses()
+{
+	m_Stats.Passes = 0;
+	m_Stats.CulledPasses = 0;
+	std::vector<bool> needed(m_Resources.size());
+	for (size_t i = 0; i < m_Resources.size(); i++)
+	{
+		needed[i] = m_Resources[i].Output;
+	}
+	//walk back from the outputs, a pass lives when a later consumer still needs one of its writes
+	for (size_t i = m_Passes.size(); i-- > 0;)
+	{
+		RenderGraphPass& pass = m_Passes[i];
+		pass.m_Live = pass.m_KeepAlive;
+		for (auto& access : pass.m_Accesses)
+		{
+			if (access.Type != RenderGraphPass::AccessType::Sampled && needed[access.Resource])
+			{
+				pass.m_Live = true;
+			}
+		}
+		if (!pass.m_Live)
+		{
+			m_Stats.CulledPasses++;
+			continue;
+		}
+		m_Stats.Passes++;
+		for (auto& access : pass.m_Accesses)
+		{
+			if (access.Type == RenderGraphPass::AccessType::Sampled)
+			{
+				needed[access.Resource] = true;
+			}
+			else
+			{
+				//a cleared or resolved attachment doesn't need what was written before
+				needed[access.Resource] = access.Type != RenderGraphPass::AccessType::Resolve && !access.Clear;
+			}
+		}
+	}
+}
+
+void RenderGraph::ComputeLifetimes()
+{
+	m_TransientStages = {};
+	m_TransientWrites = {};
+	for (auto& resource : m_Resources)
+	{
+		resource.FirstPass = UINT32_MAX;
+		resource.LastPass = 0;
+		resource.Usage = {};
+	}
+	for (uint32_t i = 0; i < m_Passes.size(); i++)
+	{
+		if (!m_Passes[i].m_Live)
+		{
+			continue;
+		}
+		for (auto& access : m_Passes[i].m_Accesses)
+		{
+			Resource& resource = m_Resources[access.Resource];
+			resource.FirstPass = (std::min)(resource.FirstPass, i);
+			resource.LastPass = (std::max)(resource.LastPass, i);
+			switch (access.Type)
+			{
+			case RenderGraphPass::AccessType::Depth:
+				resource.Usage |= vk::ImageUsageFlagBits::eDepthStencilAttachment;
+				break;
+			case RenderGraphPass::AccessType::Sampled:
+				resource.Usage |= vk::ImageUsageFlagBits::eSampled;
+				break;
+			default:
+				resource.Usage |= vk::ImageUsageFlagBits::eColorAttachment;
+				break;
+			}
+			if (!resource.Imported)
+			{
+				AccessState state = GetAccessState(access);
+				m_TransientStages |= state.Stages;
+				if (state.Write)
+				{
+					m_TransientWrites |= state.Access;
+				}
+			}
+		}
+	}
+}
+
+bool RenderGraph::IsReadAfter(RenderGraphResource resource, uint32_t passIndex)
+{
+	for (uint32_t i = passIndex + 1; i < m_Passes.size(); i++)
+	{
+		if (!m_Passes[i].m_Live)
+		{
+			continue;
+		}
+		for (auto& access : m_Passes[i].m_Accesses)
+		{
+			if (access.Resource != resource)
+			{
+				continue;
+			}
+			if (access.Type == RenderGraphPass::AccessType::Sampled || (access.Type != RenderGraphPass::AccessType::Resolve && !access.Clear))
+			{
+				return true;
+			}
+			return false;
+		}
+	}
+	return m_Resources[resource].Output;
+}
+
+void RenderGraph::BuildRenderPasses()
+{
+	//imported images may come in with contents, transients never do
+	std::vector<bool> written(m_Resources.size());
+	for (size_t i = 0; i < m_Resources.size(); i++)
+	{
+		written[i] = m_Resources[i].Imported && m_Resources[i].InitialLayout != vk::ImageLayout::eUndefined;
+	}
+	for (uint32_t i = 0; i < m_Passes.size(); i++)
+	{
+		RenderGraphPass& pass = m_Passes[i];
+		if (!pass.m_Live)
+		{
+			continue;
+		}
+		std::vector<const RenderGraphPass::Access*> colors;
+		std::vector<const RenderGraphPass::Access*> resolves;
+		const RenderGraphPass::Access* depth = nullptr;
+		for (auto& access : pass.m_Accesses)
+		{
+			switch (access.Type)
+			{
+			case RenderGraphPass::AccessType::Color:
+				colors.push_back(&access);
+				break;
+			case RenderGraphPass::AccessType::Resolve:
+				resolves.push_back(&access);
+				break;
+			case RenderGraphPass::AccessType::Depth:
+				depth = &access;
+				break;
+			default:
+				break;
+			}
+		}
+		pass.m_HasRenderPass = !colors.empty() || depth;
+		if (!pass.m_HasRenderPass)
+		{
+			continue;
+		}
+		if (resolves.size() > colors.size())
+		{
+			throw std::runtime_error("render graph pass " + pass.m_Name + " resolves more attachments than it writes!");
+		}
+
+		//colors, then depth, then resolves
+		std::vector<const RenderGraphPass::Access*> ordered = colors;
+		if (depth)
+		{
+			ordered.push_back(depth);
+		}
+		ordered.insert(ordered.end(), resolves.begin(), resolves.end());
+		std::vector<vk::AttachmentDescription> attachments;
+		std::vector<vk::ClearValue> clearValues;
+		for (auto access : ordered)
+		{
+			const Resource& resource = m_Resources[access->Resource];
+			AccessState state = GetAccessState(*access);
+			vk::AttachmentLoadOp loadOp = vk::AttachmentLoadOp::eDontCare;
+			if (access->Clear)
+			{
+				loadOp = vk::AttachmentLoadOp::eClear;
+			}
+			else if (access->Type != RenderGraphPass::AccessType::Resolve && written[access->Resource])
+			{
+				loadOp = vk::AttachmentLoadOp::eLoad;
+			}
+			vk::AttachmentStoreOp storeOp = IsReadAfter(access->Resource, i) ? vk::AttachmentStoreOp::eStore : vk::AttachmentStoreOp::eDontCare;
+			bool stencil = access->Type == RenderGraphPass::AccessType::Depth && m_Device.HasStencil(resource.Desc.Format);
+			vk::AttachmentDescription attachment;
+			attachment.setFormat(resource.Desc.Format)
+					  .setSamples(resource.Desc.Samples)
+					  .setInitialLayout(state.Layout)
+					  .setFinalLayout(state.Layout)
+					  .setLoadOp(loadOp)
+					  .setStoreOp(storeOp)
+					  .setStencilLoadOp(stencil ? loadOp : vk::AttachmentLoadOp::eDontCare)
+					  .setStencilStoreOp(stencil ? storeOp : vk::AttachmentStoreOp::eDontCare);
+			attachments.push_back(attachment);
+			clearValues.push_back(access->ClearValue);
+			written[access->Resource] = true;
+		}
+
+		std::vector<vk::AttachmentReference> colorReferences;
+		std::vector<vk::AttachmentReference> resolveReferences;
+		for (uint32_t c = 0; c < colors.size(); c++)
+		{
+			colorReferences.emplace_back(c, vk::ImageLayout::eColorAttachmentOptimal);
+		}
+		uint32_t resolveBase = static_cast<uint32_t>(colors.size()) + (depth ? 1 : 0);
+		if (!resolves.empty())
+		{
+			resolveReferences.resize(colors.size(), vk::AttachmentReference(VK_ATTACHMENT_UNUSED, vk::ImageLayout::eUndefined));
+			for (uint32_t r = 0; r < resolves.size(); r++)
+			{
+				resolveReferences[r] = vk::AttachmentReference(resolveBase + r, vk::ImageLayout::eColorAttachmentOptimal);
+			}
+		}
+		vk::AttachmentReference depthReference(static_cast<uint32_t>(colors.size()), vk::ImageLayout::eDepthStencilAttachmentOptimal);
+		vk::SubpassDescription subpass;
+		subpass.setColorAttachmentCount(static_cast<uint32_t>(colorReferences.size()))
+			   .setPColorAttachments(colorReferences.data())
+			   .setPResolveAttachments(resolveReferences.empty() ? nullptr : resolveReferences.data())
+			   .setPDepthStencilAttachment(depth ? &depthReference : nullptr)
+			   .setPipelineBindPoint(vk::PipelineBindPoint::eGraphics);
+
+		pass.m_Attachments.clear();
+		for (auto access : ordered)
+		{
+			pass.m_Attachments.push_back(access->Resource);
+		}
+		//layouts don't change inside the pass, the graph's barriers do the transitions and the syncing
+		if (m_DynamicRendering)
+		{
+			pass.m_RenderPass.CreateDynamic(m_Device, attachments, static_cast<uint32_t>(colors.size()), depth != nullptr, clearValues, vk::Rect2D({ 0, 0 }, m_Extent));
+		}
+		else
+		{
+			pass.m_RenderPass.Create(m_Device, attachments, { subpass }, {}, clearValues, vk::Rect2D({ 0, 0 }, m_Extent));
+		}
+		pass.m_RenderPass.SetName(pass.m_Name);
+	}
+}
+
+void RenderGraph::BuildBarriers()
+{
+	struct State
+	{
+		vk::ImageLayout Layout;
+		vk::PipelineStageFlags Stages;
+		vk::AccessFlags Writes;
+	};
+	std::vector<State> states(m_Resources.size());
+	for (size_t i = 0; i < m_Resources.size(); i++)
+	{
+		const Resource& resource = m_Resources[i];
+		if (resource.Imported)
+		{
+			//matches the stage the frame waits on the acquire semaphore in
+			states[i] = { resource.InitialLayout, vk::PipelineStageFlagBits::eColorAttachmentOutput, {} };
+		}
+		else
+		{
+			//starts undefined every frame, the memory may be shared with another transient or still in use by the previous frame
+			states[i] = { vk::ImageLayout::eUndefined, m_TransientStages, m_TransientWrites };
+		}
+	}
+
+	m_Stats.Barriers = 0;
+	for (auto& pass : m_Passes)
+	{
+		pass.m_Barriers.clear();
+		if (!pass.m_Live)
+		{
+			continue;
+		}
+		for (auto& access : pass.m_Accesses)
+		{
+			State& current = states[access.Resource];
+			AccessState next = GetAccessState(access);
+			//read after read in the same layout needs nothing
+			if (current.Layout == next.Layout && !current.Writes && !next.Write)
+			{
+				current.Stages |= next.Stages;
+				continue;
+			}
+			pass.m_Barriers.push_back({ access.Resource, current.Layout, next.Layout, current.Stages, current.Writes, next.Stages, next.Access });
+			current = { next.Layout, next.Stages, next.Write ? next.Access : vk::AccessFlags() };
+		}
+		m_Stats.Barriers += static_cast<uint32_t>(pass.m_Barriers.size());
+	}
+
+	m_FinalBarriers.clear();
+	for (RenderGraphResource i = 0; i < m_Resources.size(); i++)
+	{
+		const Resource& resource = m_Resources[i];
+		if (!resource.Imported || resource.FirstPass == UINT32_MAX || resource.FinalLayout == vk::ImageLayout::eUndefined)
+		{
+			continue;
+		}
+		vk::PipelineStageFlags dstStages = vk::PipelineStageFlagBits::eAllCommands;
+		vk::AccessFlags dstAccess = vk::AccessFlagBits::eMemoryRead;
+		switch (resource.FinalLayout)
+		{
+		case vk::ImageLayout::ePresentSrcKHR:
+			//the present semaphore does the rest
+			dstStages = vk::PipelineStageFlagBits::eBottomOfPipe;
+			dstAccess = {};
+			break;
+		case vk::ImageLayout::eTransferSrcOptimal:
+			dstStages = vk::PipelineStageFlagBits::eTransfer;
+			dstAccess = vk::AccessFlagBits::eTransferRead;
+			break;
+		case vk::ImageLayout::eShaderReadOnlyOptimal:
+			dstStages = vk::PipelineStageFlagBits::eFragmentShader | vk::PipelineStageFlagBits::eComputeShader;
+			dstAccess = vk::AccessFlagBits::eShaderRead;
+			break;
+		default:
+			break;
+		}
+		m_FinalBarriers.push_back({ i, states[i].Layout, resource.FinalLayout, states[i].Stages, states[i].Writes, dstStages, dstAccess });
+	}
+	m_Stats.Barriers += static_cast<uint32_t>(m_FinalBarriers.size());
+}
+
+void RenderGraph::BuildResources()
+{
+	m_Stats.TransientImages = 0;
+	m_Stats.TransientBytes = 0;
+	for (auto& resource : m_Resources)
+	{
+		if (resource.Imported || resource.FirstPass == UINT32_MAX)
+		{
+			continue;
+		}
+		vk::Extent2D extent = GetExtent(resource);
+		vk::ImageUsageFlags usage = resource.Usage;
+		//never sampled, the tiler may keep it on chip
+		if (!(usage & vk::ImageUsageFlagBits::eSampled))
+		{
+			usage |= vk::ImageUsageFlagBits::eTransientAttachment;
+		}
+		resource.Physical.CreateUnbound(m_Device, 1, resource.Desc.Samples, vk::ImageType::e2D, vk::Extent3D(extent.width, extent.height, 1), resource.Desc.Format, usage, vk::ImageTiling::eOptimal, vk::ImageLayout::eUndefined, vk::SharingMode::eExclusive, 1, {});
+		m_Stats.TransientImages++;
+	}
+	AliasMemory();
+	for (auto& resource : m_Resources)
+	{
+		if (resource.Imported || resource.FirstPass == UINT32_MAX)
+		{
+			continue;
+		}
+		resource.Physical.CreateImageView(resource.Desc.Format, GetAspect(resource));
+	}
+
+	for (auto& pass : m_Passes)
+	{
+		if (!pass.m_Live || !pass.m_HasRenderPass)
+		{
+			continue;
+		}
+		//one framebuffer per imported image index, a single one when the pass only touches transients
+		uint32_t frameBufferCount = 1;
+		for (auto& access : pass.m_Accesses)
+		{
+			if (m_Resources[access.Resource].Imported)
+			{
+				frameBufferCount = (std::max)(frameBufferCount, static_cast<uint32_t>(m_Resources[access.Resource].Imported->size()));
+			}
+		}
+		std::vector<RenderGraphPass::Access*> ordered;
+		for (auto type : { RenderGraphPass::AccessType::Color, RenderGraphPass::AccessType::Depth, RenderGraphPass::AccessType::Resolve })
+		{
+			for (auto& access : pass.m_Accesses)
+			{
+				if (access.Type == type)
+				{
+					ordered.push_back(&access);
+				}
+			}
+		}
+		pass.m_Extent = GetExtent(m_Resources[ordered.front()->Resource]);
+		pass.m_RenderPass.SetRenderArea(vk::Rect2D({ 0, 0 }, pass.m_Extent));
+		if (m_DynamicRendering)
+		{
+			//nothing to build, the views are gathered when the pass begins
+			continue;
+		}
+		std::vector<std::vector<FrameBufferAttachment>> bufferAttachments(frameBufferCount);
+		for (uint32_t f = 0; f < frameBufferCount; f++)
+		{
+			for (auto access : ordered)
+			{
+				FrameBufferAttachment::AttachmentType type = access->Type == RenderGraphPass::AccessType::Depth ? FrameBufferAttachment::AttachmentType::Depth : FrameBufferAttachment::AttachmentType::Color;
+				bufferAttachments[f].push_back({ type, GetImage(access->Resource, f) });
+			}
+		}
+		pass.m_RenderPass.BuildFrameBuffer(bufferAttachments, pass.m_Extent.width, pass.m_Extent.height);
+	}
+}
+
+void RenderGraph::AliasMemory()
+{
+	std::vector<RenderGraphResource> order;
+	for (RenderGraphResource i = 0; i < m_Resources.size(); i++)
+	{
+		if (!m_Resources[i].Imported && m_Resources[i].FirstPass != UINT32_MAX)
+		{
+			order.push_back(i);
+		}
+	}
+	std::vector<vk::MemoryRequirements> requirements(m_Resources.size());
+	for (auto index : order)
+	{
+		requirements[index] = m_Resources[index].Physical.GetMemoryRequirements();
+		m_Stats.TransientBytes += requirements[index].size;
+	}
+	//biggest first, smaller images then fit into the ranges they leave
+	std::sort(order.begin(), order.end(), [&](RenderGraphResource a, RenderGraphResource b) { return requirements[a].size > requirements[b].size; });
+
+	m_Slots.clear();
+	for (auto index : order)
+	{
+		Resource& resource = m_Resources[index];
+		const vk::MemoryRequirements& requirement = requirements[index];
+		resource.Slot = UINT32_MAX;
+		for (uint32_t s = 0; s < m_Slots.size() && resource.Slot == UINT32_MAX; s++)
+		{
+			MemorySlot& slot = m_Slots[s];
+			if (!(slot.Requirement.memoryTypeBits & requirement.memoryTypeBits))
+			{
+				continue;
+			}
+			bool overlaps = std::any_of(slot.Resources.begin(), slot.Resources.end(), [&](RenderGraphResource other) {
+				return resource.FirstPass <= m_Resources[other].LastPass && m_Resources[other].FirstPass <= resource.LastPass;
+			});
+			if (overlaps)
+			{
+				continue;
+			}
+			slot.Requirement.size = (std::max)(slot.Requirement.size, requirement.size);
+			slot.Requirement.alignment = (std::max)(slot.Requirement.alignment, requirement.alignment);
+			slot.Requirement.memoryTypeBits &= requirement.memoryTypeBits;
+			slot.Resources.push_back(index);
+			resource.Slot = s;
+		}
+		if (resource.Slot == UINT32_MAX)
+		{
+			resource.Slot = static_cast<uint32_t>(m_Slots.size());
+			m_Slots.push_back({ requirement, { index } });
+		}
+	}
+
+	m_Stats.MemorySlots = static_cast<uint32_t>(m_Slots.size());
+	m_Stats.AllocatedBytes = 0;
+	for (auto& slot : m_Slots)
+	{
+		slot.Allocation = m_Device.GetAllocator().Allocate(slot.Requirement, vk::MemoryPropertyFlagBits::eDeviceLocal, false);
+		m_Stats.AllocatedBytes += slot.Requirement.size;
+		for (auto index : slot.Resources)
+		{
+			m_Resources[index].Physical.BindMemory(slot.Allocation.Memory, slot.Allocation.Offset);
+		}
+	}
+}
+
+void RenderGraph::Execute(vk::CommandBuffer command, uint32_t imageIndex, uint32_t frameIndex)
+{
+	for (auto& pass : m_Passes)
+	{
+		if (!pass.m_Live)
+		{
+			continue;
+		}
+		RecordBarriers(command, pass.m_Barriers, imageIndex);
+		RenderGraphContext context{ command, imageIndex, frameIndex, pass.m_HasRenderPass ? pass.m_Extent : m_Extent };
+		vk::SubpassContents contents = pass.m_Secondary ? vk::SubpassContents::eSecondaryCommandBuffers : vk::SubpassContents::eInline;
+		if (pass.m_HasRenderPass && m_DynamicRendering)
+		{
+			pass.m_Views.resize(pass.m_Attachments.size());
+			for (size_t i = 0; i < pass.m_Attachments.size(); i++)
+			{
+				pass.m_Views[i] = GetImage(pass.m_Attachments[i], imageIndex).GetVkImageView();
+			}
+			context.RenderingInfo = &pass.m_RenderPass.GetInheritanceRenderingInfo();
+			pass.m_RenderPass.Begin(command, pass.m_Views, vk::Rect2D({ 0, 0 }, pass.m_Extent), contents);
+		}
+		else if (pass.m_HasRenderPass)
+		{
+			context.RenderPass = pass.m_RenderPass.GetVkRenderPass();
+			context.FrameBuffer = pass.m_RenderPass.GetFrameBuffer(imageIndex);
+			pass.m_RenderPass.Begin(command, imageIndex, vk::Rect2D({ 0, 0 }, pass.m_Extent), contents);
+		}
+		if (pass.m_Execute)
+		{
+			pass.m_Execute(context);
+		}
+		if (pass.m_HasRenderPass)
+		{
+			pass.m_RenderPass.End(command);
+		}
+	}
+	RecordBarriers(command, m_FinalBarriers, imageIndex);
+}
+
+void RenderGraph::RecordBarriers(vk::CommandBuffer command, const std::vector<RenderGraphPass::BarrierDesc>& barriers, uint32_t imageIndex)
+{
+	if (barriers.empty())
+	{
+		return;
+	}
+	//one call for everything the pass waits on
+	std::vector<vk::ImageMemoryBarrier> imageBarriers(barriers.size());
+	vk::PipelineStageFlags srcStages;
+	vk::PipelineStageFlags dstStages;
+	for (size_t i = 0; i < barriers.size(); i++)
+	{
+		const RenderGraphPass::BarrierDesc& desc = barriers[i];
+		vk::ImageSubresourceRange range;
+		range.setAspectMask(GetAspect(m_Resources[desc.Resource]))
+			 .setBaseArrayLayer(0)
+			 .setBaseMipLevel(0)
+			 .setLayerCount(1)
+			 .setLevelCount(1);
+		imageBarriers[i].sType = vk::StructureType::eImageMemoryBarrier;
+		imageBarriers[i].setImage(GetVkImage(desc.Resource, imageIndex))
+						.setSubresourceRange(range)
+						.setOldLayout(desc.OldLayout)
+						.setNewLayout(desc.NewLayout)
+						.setSrcAccessMask(desc.SrcAccess)
+						.setDstAccessMask(desc.DstAccess)
+						.setSrcQueueFamilyIndex(VK_QUEUE_FAMILY_IGNORED)
+						.setDstQueueFamilyIndex(VK_QUEUE_FAMILY_IGNORED);
+		srcStages |= desc.SrcStages;
+		dstStages |= desc.DstStages;
+	}
+	command.pipelineBarrier(srcStages, dstStages, {}, 0, nullptr, 0, nullptr, static_cast<uint32_t>(imageBarriers.size()), imageBarriers.data());
+}
+
+RenderGraphPass& RenderGraph::GetLivePass(const std::string& passName)
+{
+	for (auto& pass : m_Passes)
+	{
+		if (pass.m_Name == passName && pass.m_Live && pass.m_HasRenderPass)
+		{
+			return pass;
+		}
+	}
+	throw std::runtime_error("render graph has no live pass " + passName + "!");
+}
+
+vk::RenderPass RenderGraph::GetRenderPass(const std::string& passName)
+{
+	return GetLivePass(passName).m_RenderPass.GetVkRenderPass();
+}
+
+const std::vector<vk::Format>& RenderGraph::GetColorFormats(const std::string& passName)
+{
+	return GetLivePass(passName).m_RenderPass.GetColorFormats();
+}
+
+vk::Format RenderGraph::GetDepthFormat(const std::string& passName)
+{
+	return GetLivePass(passName).m_RenderPass.GetDepthFormat();
+}
+
+Image& RenderGraph::GetImage(RenderGraphResource resource, uint32_t imageIndex)
+{
+	Resource& graphResource = m_Resources[resource];
+	if (graphResource.Imported)
+	{
+		return (*graphResource.Imported)[(std::min)(imageIndex, static_cast<uint32_t>(graphResource.Imported->size()) - 1)];
+	}
+	return graphResource.Physical;
+}
+
+vk::Image RenderGraph::GetVkImage(RenderGraphResource resource, uint32_t imageIndex)
+{
+	return GetImage(resource, imageIndex).GetVkImage();
+}
+
+vk::Extent2D RenderGraph::GetExtent(const Resource& resource) const
+{
+	if (resource.Imported)
+	{
+		return m_Extent;
+	}
+	uint32_t width = (std::max)(1u, static_cast<uint32_t>(m_Extent.width * resource.Desc.Scale));
+	uint32_t height = (std::max)(1u, static_cast<uint32_t>(m_Extent.height * resource.Desc.Scale));
+	return vk::Extent2D(width, height);
+}
+
+vk::ImageAspectFlags RenderGraph::GetAspect(const Resource& resource)
+{
+	if (!IsDepthFormat(resource.Desc.Format))
+	{
+		return vk::ImageAspectFlagBits::eColor;
+	}
+	vk::ImageAspectFlags aspect = vk::ImageAspectFlagBits::eDepth;
+	if (m_Device.HasStencil(resource.Desc.Format))
+	{
+		aspect |= vk::ImageAspectFlagBits::eStencil;
+	}
+	return aspect;
+}
+
+bool RenderGraph::IsDepthFormat(vk::Format format)
+{
+	switch (format)
+	{
+	case vk::Format::eD16Unorm:
+	case vk::Format::eX8D24UnormPack32:
+	case vk::Format::eD32Sfloat:
+	case vk::Format::eD16UnormS8Uint:
+	case vk::Format::eD24UnormS8Uint:
+	case vk::Format::eD32SfloatS8Uint:
+		return true;
+	default:
+		return false;
+	}
+}
+
+std::function<void()> RenderGraph::TakeResources()
+{
+	std::vector<FrameBuffer> frameBuffers;
+	for (auto& pass : m_Passes)
+	{
+		if (pass.m_HasRenderPass)
+		{
+			auto& passFrameBuffers = pass.m_RenderPass.GetFrameBuffers();
+			frameBuffers.insert(frameBuffers.end(), passFrameBuffers.begin(), passFrameBuffers.end());
+			passFrameBuffers.clear();
+		}
+	}
+	std::vector<Image> images;
+	for (auto& resource : m_Resources)
+	{
+		if (!resource.Imported && resource.FirstPass != UINT32_MAX)
+		{
+			images.push_back(resource.Physical);
+			resource.Physical = Image();
+		}
+	}
+	std::vector<MemoryAllocation> allocations;
+	for (auto& slot : m_Slots)
+	{
+		allocations.push_back(slot.Allocation);
+	}
+	m_Slots.clear();
+	return [device = m_Device, frameBuffers = std::move(frameBuffers), images = std::move(images), allocations = std::move(allocations)]() mutable {
+		for (auto& frameBuffer : frameBuffers)
+		{
+			frameBuffer.Clear();
+		}
+		for (auto& image : images)
+		{
+			image.Clear();
+		}
+		for (auto& allocation : allocations)
+		{
+			device.GetAllocator().Free(allocation);
+		}
+	};
+}
+
+void RenderGraph::ClearResources()
+{
+	TakeResources()();
+}
+
+void RenderGraph::Clear()
+{
+	if (m_Compiled)
+	{
+		ClearResources();
+	}
+	for (auto& pass : m_Passes)
+	{
+		if (pass.m_HasRenderPass)
+		{
+			pass.m_RenderPass.Clear();
+		}
+	}
+	m_Passes.clear();
+	m_Resources.clear();
+	m_FinalBarriers.clear();
+	m_Compiled = false;
+}
@@ -0,0 +1,196 @@
+#pragma once
+#include "Device.h"
+#include "Image.h"
+#include "RenderPass.h"
+#include "MemoryAllocator.h"
+
+#include <vulkan/vulkan.hpp>
+#include <deque>
+#include <functional>
+#include <string>
+#include <vector>
+
+using RenderGraphResource = uint32_t;
+
+struct RenderGraphImageDesc
+{
+	vk::Format Format = vk::Format::eUndefined;
+	vk::SampleCountFlagBits Samples = vk::SampleCountFlagBits::e1;
+	//size relative to the graph extent
+	float Scale = 1.0f;
+};
+
+struct RenderGraphContext
+{
+	vk::CommandBuffer Command;
+	uint32_t ImageIndex = 0;
+	uint32_t FrameIndex = 0;
+	vk::Extent2D Extent;
+	//inheritance for secondaries of the pass, subpass 0, or the rendering info chained to it with dynamic rendering
+	vk::RenderPass RenderPass;
+	vk::Framebuffer FrameBuffer;
+	const vk::CommandBufferInheritanceRenderingInfo* RenderingInfo = nullptr;
+};
+
+struct RenderGraphStats
+{
+	uint32_t Passes = 0;
+	uint32_t CulledPasses = 0;
+	uint32_t Barriers = 0;
+	uint32_t TransientImages = 0;
+	uint32_t MemorySlots = 0;
+	//what the transients would take without aliasing and what they take with it
+	vk::DeviceSize TransientBytes = 0;
+	vk::DeviceSize AllocatedBytes = 0;
+};
+
+class RenderGraphPass
+{
+	friend class RenderGraph;
+public:
+	//without clear the attachment is loaded from the previous writer
+	RenderGraphPass& WriteColor(RenderGraphResource resource, bool clear = true, vk::ClearColorValue value = vk::ClearColorValue());
+	RenderGraphPass& WriteDepth(RenderGraphResource resource, bool clear = true, vk::ClearDepthStencilValue value = vk::ClearDepthStencilValue(1.0f, 0));
+	//resolves the next multisampled color attachment, in WriteColor order
+	RenderGraphPass& ResolveColor(RenderGraphResource resource);
+	RenderGraphPass& ReadTexture(RenderGraphResource resource, vk::PipelineStageFlags stages = vk::PipelineStageFlagBits::eFragmentShader);
+	//never culled, for passes whose effect isn't a graph resource
+	RenderGraphPass& KeepAlive() { m_KeepAlive = true; return *this; }
+	//the pass body only executes secondary command buffers, e.g. from the ParallelRecorder
+	RenderGraphPass& UseSecondaryCommandBuffers(bool enable = true) { m_Secondary = enable; return *this; }
+	RenderGraphPass& SetExecute(std::function<void(const RenderGraphContext&)> execute) { m_Execute = std::move(execute); return *this; }
+	const std::string& GetName() const { return m_Name; }
+private:
+	enum class AccessType
+	{
+		Color,
+		Depth,
+		Resolve,
+		Sampled
+	};
+	struct Access
+	{
+		RenderGraphResource Resource;
+		AccessType Type;
+		bool Clear = false;
+		vk::ClearValue ClearValue;
+		vk::PipelineStageFlags Stages;
+	};
+	//barrier resolved at compile time, the image is looked up when it's recorded
+	struct BarrierDesc
+	{
+		RenderGraphResource Resource;
+		vk::ImageLayout OldLayout;
+		vk::ImageLayout NewLayout;
+		vk::PipelineStageFlags SrcStages;
+		vk::AccessFlags SrcAccess;
+		vk::PipelineStageFlags DstStages;
+		vk::AccessFlags DstAccess;
+	};
+	std::string m_Name;
+	std::vector<Access> m_Accesses;
+	std::function<void(const RenderGraphContext&)> m_Execute;
+	bool m_KeepAlive = false;
+	bool m_Secondary = false;
+	bool m_Live = false;
+	vk::Extent2D m_Extent;
+	std::vector<BarrierDesc> m_Barriers;
+	//colors, depth, resolves, the dynamic backend looks their views up every time the pass begins
+	std::vector<RenderGraphResource> m_Attachments;
+	std::vector<vk::ImageView> m_Views;
+	//empty for passes without attachments, e.g. compute
+	RenderPass m_RenderPass;
+	bool m_HasRenderPass = false;
+};
+
+//passes declare what they read and write, the graph derives load/store ops, layouts and barriers,
+//skips passes nothing depends on and lets transient attachments with disjoint lifetimes share memory
+class RenderGraph
+{
+public:
+	void Create(Device& device);
+	//before Compile: begin passes with vkCmdBeginRendering instead of render pass and framebuffer objects
+	void SetDynamicRendering(bool enable) { m_DynamicRendering = enable; }
+	bool IsDynamicRendering() const { return m_DynamicRendering; }
+	//size and memory come from the graph, contents don't outlive the frame
+	RenderGraphResource CreateImage(const std::string& name, const RenderGraphImageDesc& desc);
+	//one image per swapchain or offscreen index, the vector is read again on Resize
+	RenderGraphResource ImportImages(const std::string& name, std::vector<Image>& images, vk::Format format, vk::ImageLayout initialLayout, vk::ImageLayout finalLayout);
+	//contents are used after the graph, imported images always are
+	void SetOutput(RenderGraphResource resource);
+	//the reference stays valid, passes run in the order they are added
+	RenderGraphPass& AddPass(const std::string& name);
+	void Compile(vk::Extent2D extent);
+	//keeps the render passes, recreates the transient images and framebuffers, the old ones go through the device's deletion queue
+	void Resize(vk::Extent2D extent);
+	void Execute(vk::CommandBuffer command, uint32_t imageIndex, uint32_t frameIndex);
+	//null with dynamic rendering, pipelines then use the pass's attachment formats
+	vk::RenderPass GetRenderPass(const std::string& passName);
+	const std::vector<vk::Format>& GetColorFormats(const std::string& passName);
+	vk::Format GetDepthFormat(const std::string& passName);
+	//recreated on Resize, descriptors that sample it have to be written again
+	Image& GetImage(RenderGraphResource resource, uint32_t imageIndex = 0);
+	const RenderGraphStats& GetStats() const { return m_Stats; }
+	void Clear();
+private:
+	struct Resource
+	{
+		std::string Name;
+		RenderGraphImageDesc Desc;
+		std::vector<Image>* Imported = nullptr;
+		vk::ImageLayout InitialLayout = vk::ImageLayout::eUndefined;
+		vk::ImageLayout FinalLayout = vk::ImageLayout::eUndefined;
+		bool Output = false;
+		vk::ImageUsageFlags Usage;
+		//first and last live pass using it, UINT32_MAX when no live pass does
+		uint32_t FirstPass = UINT32_MAX;
+		uint32_t LastPass = 0;
+		uint32_t Slot = UINT32_MAX;
+		Image Physical;
+	};
+	//a memory range shared by transients whose lifetimes don't overlap
+	struct MemorySlot
+	{
+		vk::MemoryRequirements Requirement;
+		std::vector<RenderGraphResource> Resources;
+		MemoryAllocation Allocation;
+	};
+	struct AccessState
+	{
+		vk::ImageLayout Layout;
+		vk::PipelineStageFlags Stages;
+		vk::AccessFlags Access;
+		bool Write;
+	};
+	static AccessState GetAccessState(const RenderGraphPass::Access& access);
+	RenderGraphPass& GetLivePass(const std::string& passName);
+	void CullPasses();
+	void ComputeLifetimes();
+	void BuildBarriers();
+	void BuildRenderPasses();
+	void BuildResources();
+	//moves the size dependent objects out, the returned function destroys them
+	std::function<void()> TakeResources();
+	void ClearResources();
+	void AliasMemory();
+	//a later live pass sees the contents before something overwrites them
+	bool IsReadAfter(RenderGraphResource resource, uint32_t passIndex);
+	void RecordBarriers(vk::CommandBuffer command, const std::vector<RenderGraphPass::BarrierDesc>& barriers, uint32_t imageIndex);
+	vk::Extent2D GetExtent(const Resource& resource) const;
+	vk::ImageAspectFlags GetAspect(const Resource& resource);
+	vk::Image GetVkImage(RenderGraphResource resource, uint32_t imageIndex);
+	static bool IsDepthFormat(vk::Format format);
+private:
+	Device m_Device;
+	std::vector<Resource> m_Resources;
+	std::deque<RenderGraphPass> m_Passes;
+	std::vector<MemorySlot> m_Slots;
+	std::vector<RenderGraphPass::BarrierDesc> m_FinalBarriers;
+	//every stage a transient is used in, the first use of an aliased range waits on all of them
+	vk::PipelineStageFlags m_TransientStages;
+	vk::AccessFlags m_TransientWrites;
+	vk::Extent2D m_Extent;
+	bool m_Compiled = false;
+	bool m_DynamicRendering = false;
+	RenderGraphStats m_Stats;
+};
@@ -17,6 +17,53 @@ void RenderPass::Create(Device& device, const std::vector<vk::AttachmentDescript
 	VK_CHECK_RESULT(m_Device.GetLogicDevice().createRenderPass(&renderPassInfo, nullptr, &m_RenderPass));
 }
 
+void RenderPass::CreateDynamic(Device& device, const std::vector<vk::AttachmentDescription>& attachments, uint32_t colorCount, bool hasDepth, const std::vector<vk::ClearValue>& clearValues, vk::Rect2D renderArea)
+{
+	m_Device = device;
+	m_ClearValues = clearValues;
+	m_RenderArea = renderArea;
+	m_Dynamic = true;
+	m_HasDepth = hasDepth;
+	uint32_t resolveBase = colorCount + (hasDepth ? 1 : 0);
+	m_ResolveCount = static_cast<uint32_t>(attachments.size()) - resolveBase;
+	m_ColorInfos.resize(colorCount);
+	m_ColorFormats.resize(colorCount);
+	for (uint32_t i = 0; i < colorCount; i++)
+	{
+		const vk::AttachmentDescription& attachment = attachments[i];
+		m_ColorInfos[i].sType = vk::StructureType::eRenderingAttachmentInfo;
+		m_ColorInfos[i].setImageLayout(attachment.initialLayout)
+					   .setLoadOp(attachment.loadOp)
+					   .setStoreOp(attachment.storeOp)
+					   .setClearValue(clearValues[i]);
+		if (i < m_ResolveCount)
+		{
+			m_ColorInfos[i].setResolveMode(vk::ResolveModeFlagBits::eAverage)
+						   .setResolveImageLayout(attachments[resolveBase + i].initialLayout);
+		}
+		m_ColorFormats[i] = attachment.format;
+	}
+	vk::SampleCountFlagBits samples = attachments.empty() ? vk::SampleCountFlagBits::e1 : attachments.front().samples;
+	m_DepthFormat = vk::Format::eUndefined;
+	if (hasDepth)
+	{
+		const vk::AttachmentDescription& attachment = attachments[colorCount];
+		m_DepthInfo.sType = vk::StructureType::eRenderingAttachmentInfo;
+		m_DepthInfo.setImageLayout(attachment.initialLayout)
+				   .setLoadOp(attachment.loadOp)
+				   .setStoreOp(attachment.storeOp)
+				   .setClearValue(clearValues[colorCount]);
+		m_DepthFormat = attachment.format;
+		m_HasStencil = m_Device.HasStencil(attachment.format);
+	}
+	m_InheritanceRendering.sType = vk::StructureType::eCommandBufferInheritanceRenderingInfo;
+	m_InheritanceRendering.setColorAttachmentCount(colorCount)
+						  .setPColorAttachmentFormats(m_ColorFormats.data())
+						  .setDepthAttachmentFormat(m_DepthFormat)
+						  .setStencilAttachmentFormat(m_HasStencil ? m_DepthFormat : vk::Format::eUndefined)
+						  .setRasterizationSamples(samples);
+}
+
 void RenderPass::BuildFrameBuffer(std::vector<std::vector<FrameBufferAttachment>>& attachments, uint32_t width, uint32_t height)
 {
 	uint32_t frameBufferCount = static_cast<uint32_t>(attachments.size());
@@ -31,28 +78,59 @@ void RenderPass::BuildFrameBuffer(std::vector<std::vector<FrameBufferAttachment>
 	}
 }
 
-void RenderPass::Begin(vk::CommandBuffer command, uint32_t imageIndex, vk::Rect2D renderArea)
+void RenderPass::Begin(vk::CommandBuffer command, uint32_t imageIndex, vk::Rect2D renderArea, vk::SubpassContents contents)
 {
 	vk::RenderPassBeginInfo renderPassBegin;
 	renderPassBegin.sType = vk::StructureType::eRenderPassBeginInfo;
 	renderPassBegin.setClearValueCount(static_cast<uint32_t>(m_ClearValues.size()))
 				   .setPClearValues(m_ClearValues.data())
 				   .setRenderPass(m_RenderPass)
-				   .setRenderArea(renderArea);
-	if (m_IsPresentPass)
+				   .setRenderArea(renderArea)
+				   .setFramebuffer(GetFrameBuffer(imageIndex));
+	m_Device.GetProfiler().BeginGpu(command, m_Name);
+	command.beginRenderPass(&renderPassBegin, contents);
+}
+
+void RenderPass::Begin(vk::CommandBuffer command, const std::vector<vk::ImageView>& views, vk::Rect2D renderArea, vk::SubpassContents contents)
+{
+	uint32_t colorCount = static_cast<uint32_t>(m_ColorInfos.size());
+	uint32_t resolveBase = colorCount + (m_HasDepth ? 1 : 0);
+	for (uint32_t i = 0; i < colorCount; i++)
 	{
-		renderPassBegin.setFramebuffer(m_FrameBuffers[imageIndex].GetVkFrameBuffer());
+		m_ColorInfos[i].setImageView(views[i]);
+		if (i < m_ResolveCount)
+		{
+			m_ColorInfos[i].setResolveImageView(views[resolveBase + i]);
+		}
 	}
-	else 
+	if (m_HasDepth)
 	{
-		renderPassBegin.setFramebuffer(m_FrameBuffers[0].GetVkFrameBuffer());
+		m_DepthInfo.setImageView(views[colorCount]);
 	}
-	command.beginRenderPass(&renderPassBegin, vk::SubpassContents::eInline);
+	vk::RenderingInfo renderingInfo;
+	renderingInfo.sType = vk::StructureType::eRenderingInfo;
+	renderingInfo.setRenderArea(renderArea)
+				 .setLayerCount(1)
+				 .setColorAttachmentCount(colorCount)
+				 .setPColorAttachments(m_ColorInfos.data())
+				 .setPDepthAttachment(m_HasDepth ? &m_DepthInfo : nullptr)
+				 .setPStencilAttachment(m_HasStencil ? &m_DepthInfo : nullptr)
+				 .setFlags(contents == vk::SubpassContents::eSecondaryCommandBuffers ? vk::RenderingFlagBits::eContentsSecondaryCommandBuffers : vk::RenderingFlags());
+	m_Device.GetProfiler().BeginGpu(command, m_Name);
+	command.beginRendering(&renderingInfo);
 }
 
 void RenderPass::End(vk::CommandBuffer command)
 {
-	command.endRenderPass();
+	if (m_Dynamic)
+	{
+		command.endRendering();
+	}
+	else
+	{
+		command.endRenderPass();
+	}
+	m_Device.GetProfiler().EndGpu(command);
 }
 
 void RenderPass::ReBuildFrameBuffer(std::vector<std::vector<FrameBufferAttachment>>& attachments, uint32_t width, uint32_t height)
@@ -75,5 +153,8 @@ void RenderPass::ClearFrameBuffer()
 void RenderPass::Clear()
 {
 	ClearFrameBuffer();
-	m_Device.GetLogicDevice().destroyRenderPass(m_RenderPass, nullptr);
+	if (m_RenderPass)
+	{
+		m_Device.GetLogicDevice().destroyRenderPass(m_RenderPass, nullptr);
+	}
 }
\ No newline at end of file
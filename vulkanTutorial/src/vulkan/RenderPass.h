@@ -4,6 +4,7 @@
 #include "Device.h"
 #include "FrameBuffer.h"
 
+#include <string>
 #include <vector>
 #include <vulkan/vulkan.hpp>
 
@@ -11,15 +12,28 @@ class RenderPass
 {
 public:
 	void Create(Device& device, const std::vector<vk::AttachmentDescription>& attachments, const std::vector<vk::SubpassDescription>& subpass, const std::vector<vk::SubpassDependency>& dependencies, const std::vector<vk::ClearValue>& clearValues, vk::Rect2D renderArea);
+	//dynamic rendering: no vk::RenderPass and no framebuffers, attachments are colors, then depth, then one resolve per leading color,
+	//each staying in the layout it is described with, the views are handed to Begin
+	void CreateDynamic(Device& device, const std::vector<vk::AttachmentDescription>& attachments, uint32_t colorCount, bool hasDepth, const std::vector<vk::ClearValue>& clearValues, vk::Rect2D renderArea);
 	void BuildFrameBuffer(std::vector<std::vector<FrameBufferAttachment>>& attachments, uint32_t width, uint32_t height);
 	void ReBuildFrameBuffer(std::vector<std::vector<FrameBufferAttachment>>& attachments, uint32_t width, uint32_t height);
 	void ClearFrameBuffer();
 	void SetRenderArea(vk::Rect2D renderArea) { m_RenderArea = renderArea; }
-	void Begin(vk::CommandBuffer command, uint32_t imageIndex, vk::Rect2D renderArea);
+	void SetName(const std::string& name) { m_Name = name; }
+	//with eSecondaryCommandBuffers the subpass may only execute secondaries
+	void Begin(vk::CommandBuffer command, uint32_t imageIndex, vk::Rect2D renderArea, vk::SubpassContents contents = vk::SubpassContents::eInline);
+	//dynamic rendering, one view per attachment in CreateDynamic order
+	void Begin(vk::CommandBuffer command, const std::vector<vk::ImageView>& views, vk::Rect2D renderArea, vk::SubpassContents contents = vk::SubpassContents::eInline);
 	void Clear();
 	void End(vk::CommandBuffer command);
 	vk::RenderPass GetVkRenderPass() { return m_RenderPass; }
 	std::vector<FrameBuffer>& GetFrameBuffers() { return m_FrameBuffers; }
+	vk::Framebuffer GetFrameBuffer(uint32_t imageIndex) { return m_FrameBuffers[m_IsPresentPass ? imageIndex : 0].GetVkFrameBuffer(); }
+	bool IsDynamic() const { return m_Dynamic; }
+	//what pipelines and secondaries of a dynamic pass are created against
+	const std::vector<vk::Format>& GetColorFormats() const { return m_ColorFormats; }
+	vk::Format GetDepthFormat() const { return m_DepthFormat; }
+	const vk::CommandBufferInheritanceRenderingInfo& GetInheritanceRenderingInfo() const { return m_InheritanceRendering; }
 
 private:
 	Device m_Device;
@@ -28,4 +42,16 @@ private:
 	std::vector<vk::ClearValue> m_ClearValues;
 	vk::Rect2D m_RenderArea;
 	bool m_IsPresentPass = false;
+	bool m_Dynamic = false;
+	//filled once in CreateDynamic, Begin only sets the views
+	std::vector<vk::RenderingAttachmentInfo> m_ColorInfos;
+	vk::RenderingAttachmentInfo m_DepthInfo;
+	bool m_HasDepth = false;
+	bool m_HasStencil = false;
+	uint32_t m_ResolveCount = 0;
+	std::vector<vk::Format> m_ColorFormats;
+	vk::Format m_DepthFormat = vk::Format::eUndefined;
+	vk::CommandBufferInheritanceRenderingInfo m_InheritanceRendering;
+	//gpu profiler scope name
+	std::string m_Name = "renderpass";
 };
\ No newline at end of file
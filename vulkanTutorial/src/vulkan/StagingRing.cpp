@@ -0,0 +1,164 @@
+#include "../Core.h"
+#include "StagingRing.h"
+#include <cstring>
+
+static vk::DeviceSize AlignUp(vk::DeviceSize value, vk::DeviceSize alignment)
+{
+	return (value + alignment - 1) / alignment * alignment;
+}
+
+void StagingRing::Create(vk::Device device, MemoryAllocator& allocator, UploadContext& upload, vk::DeviceSize size)
+{
+	m_Device = device;
+	m_Allocator = &allocator;
+	m_Upload = &upload;
+	m_Size = size;
+
+	vk::BufferCreateInfo bufferInfo;
+	bufferInfo.sType = vk::StructureType::eBufferCreateInfo;
+	bufferInfo.setSharingMode(vk::SharingMode::eExclusive)
+			  .setSize(size)
+			  .setUsage(vk::BufferUsageFlagBits::eTransferSrc);
+	VK_CHECK_RESULT(m_Device.createBuffer(&bufferInfo, nullptr, &m_Buffer));
+	vk::MemoryRequirements requirement = m_Device.getBufferMemoryRequirements(m_Buffer);
+	m_Allocation = m_Allocator->Allocate(requirement, vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent, true);
+	m_Device.bindBufferMemory(m_Buffer, m_Allocation.Memory, m_Allocation.Offset);
+}
+
+StagingRange StagingRing::Allocate(vk::DeviceSize size, vk::DeviceSize alignment)
+{
+	if (size > m_Size)
+	{
+		return AllocateFallback(size);
+	}
+	Reclaim();
+	vk::DeviceSize offset = 0;
+	while (!TryAllocate(size, alignment, &offset))
+	{
+		//the whole ring belongs to the batch still being recorded, its ticket can't retire before the caller submits
+		if (m_Regions.front().Ticket == m_Upload->GetPendingTicket())
+		{
+			return AllocateFallback(size);
+		}
+		//ring is full: the oldest range has to retire before its space can be reused
+		m_Upload->Wait(m_Regions.front().Ticket);
+		m_Stats.Stalls++;
+		Reclaim();
+	}
+
+	UploadTicket ticket = m_Upload->GetPendingTicket();
+	if (!m_Regions.empty() && m_Regions.back().Ticket == ticket && offset >= m_Regions.back().End)
+	{
+		m_Regions.back().End = offset + size;
+	}
+	else
+	{
+		m_Regions.push_back({ offset, offset + size, ticket });
+	}
+	m_Stats.BytesThisFrame += size;
+	m_Stats.TotalBytes += size;
+
+	StagingRange range;
+	range.Buffer = m_Buffer;
+	range.Offset = offset;
+	range.Size = size;
+	range.Mapped = static_cast<char*>(m_Allocation.Mapped) + offset;
+	return range;
+}
+
+StagingRange StagingRing::Upload(const void* data, vk::DeviceSize size, vk::DeviceSize alignment)
+{
+	StagingRange range = Allocate(size, alignment);
+	memcpy(range.Mapped, data, static_cast<size_t>(size));
+	return range;
+}
+
+void StagingRing::NextFrame()
+{
+	m_Stats.BytesLastFrame = m_Stats.BytesThisFrame;
+	m_Stats.BytesThisFrame = 0;
+}
+
+void StagingRing::Clear()
+{
+	m_Upload->Flush();
+	Reclaim();
+	m_Device.destroyBuffer(m_Buffer, nullptr);
+	m_Allocator->Free(m_Allocation);
+}
+
+bool StagingRing::TryAllocate(vk::DeviceSize size, vk::DeviceSize alignment, vk::DeviceSize* offset)
+{
+	vk::DeviceSize aligned = AlignUp(m_Head, alignment);
+	if (m_Regions.empty() || m_Head > m_Tail)
+	{
+		//live data sits in [tail, head): free space at the end, then at the start of the ring
+		if (aligned + size <= m_Size)
+		{
+			*offset = aligned;
+			m_Head = aligned + size;
+			return true;
+		}
+		if (size <= m_Tail)
+		{
+			*offset = 0;
+			m_Head = size;
+			return true;
+		}
+		return false;
+	}
+	//wrapped: the only free space is [head, tail)
+	if (aligned + size <= m_Tail)
+	{
+		*offset = aligned;
+		m_Head = aligned + size;
+		return true;
+	}
+	return false;
+}
+
+void StagingRing::Reclaim()
+{
+	while (!m_Regions.empty() && m_Upload->IsComplete(m_Regions.front().Ticket))
+	{
+		m_Regions.pop_front();
+	}
+	if (m_Regions.empty())
+	{
+		m_Head = 0;
+		m_Tail = 0;
+	}
+	else
+	{
+		m_Tail = m_Regions.front().Begin;
+	}
+}
+
+StagingRange StagingRing::AllocateFallback(vk::DeviceSize size)
+{
+	//larger than the whole ring: use a one-off buffer that is released with its upload batch
+	StagingRange range;
+	vk::BufferCreateInfo bufferInfo;
+	bufferInfo.sType = vk::StructureType::eBufferCreateInfo;
+	bufferInfo.setSharingMode(vk::SharingMode::eExclusive)
+			  .setSize(size)
+			  .setUsage(vk::BufferUsageFlagBits::eTransferSrc);
+	VK_CHECK_RESULT(m_Device.createBuffer(&bufferInfo, nullptr, &range.Buffer));
+	vk::MemoryRequirements requirement = m_Device.getBufferMemoryRequirements(range.Buffer);
+	MemoryAllocation allocation = m_Allocator->Allocate(requirement, vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent, true);
+	m_Device.bindBufferMemory(range.Buffer, allocation.Memory, allocation.Offset);
+	range.Size = size;
+	range.Mapped = allocation.Mapped;
+
+	vk::Device device = m_Device;
+	MemoryAllocator* allocator = m_Allocator;
+	vk::Buffer buffer = range.Buffer;
+	m_Upload->Release([device, allocator, buffer, allocation]() mutable {
+		device.destroyBuffer(buffer, nullptr);
+		allocator->Free(allocation);
+	});
+	m_Stats.Fallbacks++;
+	m_Stats.BytesThisFrame += size;
+	m_Stats.TotalBytes += size;
+	return range;
+}
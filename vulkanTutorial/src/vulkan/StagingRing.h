@@ -0,0 +1,55 @@
+#pragma once
+#include "MemoryAllocator.h"
+#include "UploadContext.h"
+#include <vulkan/vulkan.hpp>
+#include <deque>
+
+struct StagingRange
+{
+	vk::Buffer Buffer;
+	vk::DeviceSize Offset = 0;
+	vk::DeviceSize Size = 0;
+	void* Mapped = nullptr;
+};
+
+struct StagingStats
+{
+	vk::DeviceSize BytesThisFrame = 0;
+	vk::DeviceSize BytesLastFrame = 0;
+	vk::DeviceSize TotalBytes = 0;
+	uint32_t Stalls = 0;
+	uint32_t Fallbacks = 0;
+};
+
+//persistently mapped host buffer handed out in aligned sub-ranges, a range is reused once its upload ticket retires
+class StagingRing
+{
+public:
+	void Create(vk::Device device, MemoryAllocator& allocator, UploadContext& upload, vk::DeviceSize size = 64 * 1024 * 1024);
+	StagingRange Allocate(vk::DeviceSize size, vk::DeviceSize alignment = 16);
+	StagingRange Upload(const void* data, vk::DeviceSize size, vk::DeviceSize alignment = 16);
+	void NextFrame();
+	const StagingStats& GetStats() const { return m_Stats; }
+	void Clear();
+private:
+	struct Region
+	{
+		vk::DeviceSize Begin;
+		vk::DeviceSize End;
+		UploadTicket Ticket;
+	};
+	bool TryAllocate(vk::DeviceSize size, vk::DeviceSize alignment, vk::DeviceSize* offset);
+	void Reclaim();
+	StagingRange AllocateFallback(vk::DeviceSize size);
+private:
+	vk::Device m_Device;
+	MemoryAllocator* m_Allocator = nullptr;
+	UploadContext* m_Upload = nullptr;
+	vk::Buffer m_Buffer;
+	MemoryAllocation m_Allocation;
+	vk::DeviceSize m_Size = 0;
+	vk::DeviceSize m_Head = 0;
+	vk::DeviceSize m_Tail = 0;
+	std::deque<Region> m_Regions;
+	StagingStats m_Stats;
+};
@@ -1,16 +1,16 @@
 #include "../Core.h"
 #include "SwapChain.h"
 
-void SwapChain::Init(Device& device, const Window& window, vk::SampleCountFlagBits sampleBits, bool vSync, bool hasDepth)
+void SwapChain::Init(Device& device, const Window& window, vk::SampleCountFlagBits sampleBits, const PresentPolicy& policy, bool hasDepth)
 {
 	m_Device = device;
 	m_CommandManager = device.GetCommandManager();
 	m_Window = window;
-	m_vSync = vSync;
+	m_Policy = policy;
 	Create();
 }
 
-void SwapChain::Create()
+void SwapChain::Create(vk::SwapchainKHR oldSwapChain)
 {
 	auto formats = m_Device.GetSurfaceSupportFormats();
 	auto presentModes = m_Device.GetSurfaceSupportPresentModes();
@@ -29,7 +29,7 @@ void SwapChain::Create()
 	m_ColorSpace = surfaceFormat.colorSpace;
 
 	m_PresentMode = vk::PresentModeKHR::eFifo;
-	if (!m_vSync)
+	if (!m_Policy.VSync)
 	{
 		for (const auto& mode : presentModes)
 		{
@@ -58,7 +58,8 @@ void SwapChain::Create()
 		m_Extent.setWidth(width).setHeight(height);
 	}
 
-	m_ImageCount = capability.minImageCount + 1;
+	//fewer images queue fewer frames ahead of the display, more keep mailbox from stalling
+	m_ImageCount = m_Policy.ImageCount > 0 ? (std::max)(m_Policy.ImageCount, capability.minImageCount) : capability.minImageCount + 1;
 	if (capability.maxImageCount > 0 && m_ImageCount > capability.maxImageCount)
 	{
 		m_ImageCount = capability.maxImageCount;
@@ -104,7 +105,8 @@ void SwapChain::Create()
 				 .setMinImageCount(m_ImageCount)
 				 .setPresentMode(m_PresentMode)
 				 .setPreTransform(preTransform)
-				 .setSurface(m_Device.GetSurface());
+				 .setSurface(m_Device.GetSurface())
+				 .setOldSwapchain(oldSwapChain);
 	if (queueIndices.GraphicQueueIndex != queueIndices.PresentQueueIndex)
 	{
 		std::array<uint32_t, 2> indices = { queueIndices.GraphicQueueIndex.value(), queueIndices.PresentQueueIndex.value() };
@@ -138,10 +140,17 @@ void SwapChain::ReCreate()
 		glfwWaitEvents();
 	}
 
-	m_Device.GetLogicDevice().waitIdle();
-
-	Clear();
-	Create();
+	//the old swapchain is retired by passing it along, frames still in flight may present to it until they are done
+	vk::SwapchainKHR oldSwapChain = m_SwapChain;
+	std::vector<ImageView> oldViews = m_SwapChainImageViews;
+	Create(oldSwapChain);
+	m_Device.GetDeletionQueue().Release([device = m_Device.GetLogicDevice(), oldSwapChain, oldViews]() mutable {
+		for (auto& view : oldViews)
+		{
+			view.Clear();
+		}
+		device.destroySwapchainKHR(oldSwapChain);
+	});
 }
 
 SwapChain::~SwapChain()
@@ -165,18 +174,19 @@ void SwapChain::Clear()
 	}
 }
 
-void SwapChain::AcquireNextImage(uint32_t* imageIndex, vk::Semaphore waitAcquireImage, AppBase* app)
+bool SwapChain::AcquireNextImage(uint32_t* imageIndex, vk::Semaphore waitAcquireImage, AppBase* app)
 {
 	auto acquireImageResult = m_Device.GetLogicDevice().acquireNextImageKHR(m_SwapChain, (std::numeric_limits<uint64_t>::max)(), waitAcquireImage, VK_NULL_HANDLE, imageIndex);
-	if (acquireImageResult == vk::Result::eErrorOutOfDateKHR || acquireImageResult == vk::Result::eSuboptimalKHR || m_Window.GetWindowResized())
+	if (acquireImageResult == vk::Result::eErrorOutOfDateKHR)
 	{
+		//no image was acquired and the semaphore is left unsignaled, the caller has to skip this frame
 		m_Window.SetWindowResized(false);
 		ReCreate();
 		app->RebuildFrameBuffer();
-		app->CreateSetLayout();
-		//app->BuildAndUpdateDescriptorSets();
-		return;
+		return false;
 	}
+	//suboptimal or resized: the image is still valid, PresentImage rebuilds after presenting it
+	return true;
 }
 
 void SwapChain::PresentImage(uint32_t imageIndex, vk::Semaphore waitDrawFinish, AppBase* app)
@@ -195,7 +205,5 @@ void SwapChain::PresentImage(uint32_t imageIndex, vk::Semaphore waitDrawFinish,
 		m_Window.SetWindowResized(false);
 		ReCreate();
 		app->RebuildFrameBuffer();
-		app->CreateSetLayout();
-		//app->BuildAndUpdateDescriptorSets();
 	}
 }
\ No newline at end of file
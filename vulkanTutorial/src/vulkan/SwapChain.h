@@ -7,14 +7,27 @@
 
 #include <vulkan/vulkan.hpp>
 
-class GLTFApp;
+//how frames reach the screen, the pacing part is applied by the FrameRing
+struct PresentPolicy
+{
+	//fifo, otherwise mailbox or immediate when the surface has them
+	bool VSync = false;
+	//0 takes one more than the surface minimum, clamped to what the surface supports
+	uint32_t ImageCount = 0;
+	//waits on the oldest frame in flight before input is sampled, so it reaches the screen sooner
+	bool LowLatency = false;
+	//0 for no cap
+	double MaxFps = 0.0;
+};
+
 class SwapChain
 {
 public:
-	void Init(Device& device, const Window& window, vk::SampleCountFlagBits sampleBits, bool vSync, bool hasDepth);
-	void Create();
+	void Init(Device& device, const Window& window, vk::SampleCountFlagBits sampleBits, const PresentPolicy& policy, bool hasDepth);
+	void Create(vk::SwapchainKHR oldSwapChain = nullptr);
+	//no device wait, the old swapchain and its views are released once the frames using them have finished
 	void ReCreate();
-	void AcquireNextImage(uint32_t* imageIndex, vk::Semaphore waitAcquireImage, AppBase* app);
+	bool AcquireNextImage(uint32_t* imageIndex, vk::Semaphore waitAcquireImage, AppBase* app);
 	void PresentImage(uint32_t imageIndex, vk::Semaphore waitDrawFinish, AppBase* app);
 	~SwapChain();
 	void Clear();
@@ -25,11 +38,13 @@ public:
 	std::vector<vk::Image> GetSwapChainImages() { return m_SwapChainImages; }
 	std::vector<ImageView> GetSwapChainImageViews() { return m_SwapChainImageViews; }
 	uint32_t GetImageCount() { return m_ImageCount; }
+	vk::PresentModeKHR GetPresentMode() { return m_PresentMode; }
+	const PresentPolicy& GetPresentPolicy() { return m_Policy; }
 	std::vector<Image>& GetImages() { return m_Images; }
 private:
 	Device m_Device;
 	CommandManager m_CommandManager;
-	bool m_vSync;
+	PresentPolicy m_Policy;
 	Window m_Window;
 	vk::SwapchainKHR m_SwapChain;
 	vk::SurfaceCapabilitiesKHR m_Capabilities;
@@ -1,19 +1,20 @@
 #include "../Core.h"
 #include "Texture.h"
 #include "stb_image.h"
-#include "Buffer.h"
 
 void Texture::Create(Device& device, const char* path, vk::Format format, bool generateMipmaps)
 {
 	
 	int width, height, channel;
-	stbi_set_flip_vertically_on_load(1);
+	//per thread so decodes running on the job system keep their own orientation
+	stbi_set_flip_vertically_on_load_thread(1);
 	stbi_uc* pixels = stbi_load(path, &width, &height, &channel, STBI_rgb_alpha);
 	if (!pixels)
 	{
 		throw std::runtime_error("read imagefile failed!");
 	}
 	FromBuffer(device, pixels, width * height * 4, format, width, height, generateMipmaps);
+	stbi_image_free(pixels);
 }
 
 void Texture::FromBuffer(Device& device, void* data, vk::DeviceSize size, vk::Format format, uint32_t texWidth, uint32_t texHeight, bool generateMipmaps)
@@ -27,21 +28,28 @@ void Texture::FromBuffer(Device& device, void* data, vk::DeviceSize size, vk::Fo
 		m_MipLevel = 1;
 	}
 
-	Buffer stagingBuffer;
-	stagingBuffer.Create(m_Device, vk::BufferUsageFlagBits::eTransferSrc, size, vk::SharingMode::eExclusive, vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent, data);
+	StagingRange staging = m_Device.GetStagingRing().Upload(data, size);
 
-	m_Image.Create(m_Device, m_MipLevel, vk::SampleCountFlagBits::e1, vk::ImageType::e2D, vk::Extent3D(m_Width, m_Height, 1), format, vk::ImageUsageFlagBits::eSampled, vk::ImageTiling::eOptimal, vk::MemoryPropertyFlagBits::eDeviceLocal, vk::ImageLayout::eUndefined, vk::SharingMode::eExclusive, 1, {});
+	vk::ImageUsageFlags usage = vk::ImageUsageFlagBits::eSampled | vk::ImageUsageFlagBits::eTransferDst;
+	if (generateMipmaps)
+	{
+		usage |= vk::ImageUsageFlagBits::eTransferSrc;
+	}
+	m_Image.Create(m_Device, m_MipLevel, vk::SampleCountFlagBits::e1, vk::ImageType::e2D, vk::Extent3D(m_Width, m_Height, 1), format, usage, vk::ImageTiling::eOptimal, vk::MemoryPropertyFlagBits::eDeviceLocal, vk::ImageLayout::eUndefined, vk::SharingMode::eExclusive, 1, {});
 	m_Image.CreateImageView(format);
 
 	m_Image.TransiationLayout(vk::PipelineStageFlagBits::eTopOfPipe, vk::AccessFlagBits::eNone, vk::ImageLayout::eUndefined, vk::PipelineStageFlagBits::eTransfer, vk::AccessFlagBits::eTransferWrite, vk::ImageLayout::eTransferDstOptimal, vk::ImageAspectFlagBits::eColor);
 
-	m_Image.CopyBufferToImage(stagingBuffer.m_Buffer, vk::Extent3D(m_Width, m_Height, 1), vk::ImageLayout::eShaderReadOnlyOptimal);
+	m_Image.CopyBufferToImage(staging.Buffer, vk::Extent3D(m_Width, m_Height, 1), vk::ImageLayout::eTransferDstOptimal, staging.Offset);
 
 	if (generateMipmaps)
 	{
 		m_Image.GenerateMipMaps();
 	}
-	//stagingBuffer.Clear();
+	else
+	{
+		m_Image.TransiationLayout(vk::PipelineStageFlagBits::eTransfer, vk::AccessFlagBits::eTransferWrite, vk::ImageLayout::eTransferDstOptimal, vk::PipelineStageFlagBits::eFragmentShader, vk::AccessFlagBits::eShaderRead, vk::ImageLayout::eShaderReadOnlyOptimal, vk::ImageAspectFlagBits::eColor);
+	}
 	CreateSampler();
 	CreateDescriptor();
 }
@@ -0,0 +1,155 @@
+#include "../Core.h"
+#include "UploadContext.h"
+#include <limits>
+
+void UploadContext::Create(vk::Device device, vk::Queue queue, uint32_t queueFamilyIndex)
+{
+	m_Device = device;
+	m_Queue = queue;
+	vk::CommandPoolCreateInfo poolInfo;
+	poolInfo.sType = vk::StructureType::eCommandPoolCreateInfo;
+	poolInfo.setFlags(vk::CommandPoolCreateFlagBits::eResetCommandBuffer | vk::CommandPoolCreateFlagBits::eTransient)
+			.setQueueFamilyIndex(queueFamilyIndex);
+	VK_CHECK_RESULT(m_Device.createCommandPool(&poolInfo, nullptr, &m_Pool));
+}
+
+vk::CommandBuffer UploadContext::GetCommandBuffer()
+{
+	if (m_Command)
+	{
+		return m_Command;
+	}
+	Collect();
+	if (!m_FreeCommands.empty())
+	{
+		m_Command = m_FreeCommands.back();
+		m_FreeCommands.pop_back();
+		m_Command.reset();
+	}
+	else
+	{
+		vk::CommandBufferAllocateInfo bufferInfo;
+		bufferInfo.sType = vk::StructureType::eCommandBufferAllocateInfo;
+		bufferInfo.setCommandBufferCount(1)
+				  .setCommandPool(m_Pool)
+				  .setLevel(vk::CommandBufferLevel::ePrimary);
+		VK_CHECK_RESULT(m_Device.allocateCommandBuffers(&bufferInfo, &m_Command));
+	}
+	vk::CommandBufferBeginInfo beginInfo;
+	beginInfo.sType = vk::StructureType::eCommandBufferBeginInfo;
+	beginInfo.setFlags(vk::CommandBufferUsageFlagBits::eOneTimeSubmit);
+	VK_CHECK_RESULT(m_Command.begin(&beginInfo));
+	return m_Command;
+}
+
+void UploadContext::Release(std::function<void()> deleter)
+{
+	m_PendingGarbage.push_back(std::move(deleter));
+}
+
+UploadTicket UploadContext::Submit()
+{
+	if (!m_Command)
+	{
+		//nothing recorded, the batch retires together with the previous one
+		if (!m_PendingGarbage.empty())
+		{
+			if (m_InFlight.empty())
+			{
+				for (auto& deleter : m_PendingGarbage)
+				{
+					deleter();
+				}
+			}
+			else
+			{
+				auto& last = m_InFlight.back().Garbage;
+				last.insert(last.end(), m_PendingGarbage.begin(), m_PendingGarbage.end());
+			}
+			m_PendingGarbage.clear();
+		}
+		return m_NextTicket - 1;
+	}
+	m_Command.end();
+
+	Submission submission;
+	submission.Ticket = m_NextTicket++;
+	submission.Command = m_Command;
+	submission.Garbage = std::move(m_PendingGarbage);
+	m_PendingGarbage.clear();
+	if (!m_FreeFences.empty())
+	{
+		submission.Fence = m_FreeFences.back();
+		m_FreeFences.pop_back();
+	}
+	else
+	{
+		vk::FenceCreateInfo fenceInfo;
+		fenceInfo.sType = vk::StructureType::eFenceCreateInfo;
+		VK_CHECK_RESULT(m_Device.createFence(&fenceInfo, nullptr, &submission.Fence));
+	}
+
+	vk::SubmitInfo submitInfo;
+	submitInfo.sType = vk::StructureType::eSubmitInfo;
+	submitInfo.setCommandBufferCount(1)
+			  .setPCommandBuffers(&submission.Command);
+	VK_CHECK_RESULT(m_Queue.submit(1, &submitInfo, submission.Fence));
+	m_Command = nullptr;
+	m_InFlight.push_back(std::move(submission));
+	return m_InFlight.back().Ticket;
+}
+
+void UploadContext::Wait(UploadTicket ticket)
+{
+	if (ticket >= m_NextTicket)
+	{
+		ticket = Submit();
+	}
+	while (!m_InFlight.empty() && m_InFlight.front().Ticket <= ticket)
+	{
+		Submission& submission = m_InFlight.front();
+		VK_CHECK_RESULT(m_Device.waitForFences(1, &submission.Fence, VK_TRUE, (std::numeric_limits<uint64_t>::max)()));
+		Retire(submission);
+		m_InFlight.pop_front();
+	}
+}
+
+bool UploadContext::IsComplete(UploadTicket ticket)
+{
+	Collect();
+	return ticket <= m_CompletedTicket;
+}
+
+void UploadContext::Collect()
+{
+	//submissions on one queue retire in order, so only the front needs polling
+	while (!m_InFlight.empty() && m_Device.getFenceStatus(m_InFlight.front().Fence) == vk::Result::eSuccess)
+	{
+		Retire(m_InFlight.front());
+		m_InFlight.pop_front();
+	}
+}
+
+void UploadContext::Retire(Submission& submission)
+{
+	for (auto& deleter : submission.Garbage)
+	{
+		deleter();
+	}
+	VK_CHECK_RESULT(m_Device.resetFences(1, &submission.Fence));
+	m_FreeFences.push_back(submission.Fence);
+	m_FreeCommands.push_back(submission.Command);
+	m_CompletedTicket = submission.Ticket;
+}
+
+void UploadContext::Clear()
+{
+	Flush();
+	for (auto& fence : m_FreeFences)
+	{
+		m_Device.destroyFence(fence, nullptr);
+	}
+	m_FreeFences.clear();
+	m_FreeCommands.clear();
+	m_Device.destroyCommandPool(m_Pool, nullptr);
+}
@@ -0,0 +1,44 @@
+#pragma once
+#include <vulkan/vulkan.hpp>
+#include <deque>
+#include <functional>
+#include <vector>
+
+using UploadTicket = uint64_t;
+
+//records copies, barriers and mip blits into one command buffer and submits them as a single batch
+class UploadContext
+{
+public:
+	void Create(vk::Device device, vk::Queue queue, uint32_t queueFamilyIndex);
+	vk::CommandBuffer GetCommandBuffer();
+	void Release(std::function<void()> deleter);
+	UploadTicket Submit();
+	void Wait(UploadTicket ticket);
+	bool IsComplete(UploadTicket ticket);
+	void Flush() { Wait(Submit()); }
+	UploadTicket GetPendingTicket() const { return m_NextTicket; }
+	UploadTicket GetCompletedTicket() const { return m_CompletedTicket; }
+	void Collect();
+	void Clear();
+private:
+	struct Submission
+	{
+		UploadTicket Ticket;
+		vk::Fence Fence;
+		vk::CommandBuffer Command;
+		std::vector<std::function<void()>> Garbage;
+	};
+	void Retire(Submission& submission);
+private:
+	vk::Device m_Device;
+	vk::Queue m_Queue;
+	vk::CommandPool m_Pool;
+	vk::CommandBuffer m_Command = nullptr;
+	std::vector<std::function<void()>> m_PendingGarbage;
+	std::deque<Submission> m_InFlight;
+	std::vector<vk::CommandBuffer> m_FreeCommands;
+	std::vector<vk::Fence> m_FreeFences;
+	UploadTicket m_NextTicket = 1;
+	UploadTicket m_CompletedTicket = 0;
+};
@@ -1,88 +1,494 @@
 #include "../Core.h"
 #include "glTFModel.h"
+#include "../core/JobSystem.h"
+#include "../core/PixelConvert.h"
+#include "../core/Hash.h"
+#include "stb_image.h"
 #include <gtc/type_ptr.hpp>
+#include <filesystem>
+#include <fstream>
+#include <cstring>
+#include <mutex>
+#include <algorithm>
 
-void GlTFModel::LoadModel(Device& device, const std::string& filaname)
+//below this many objects the cull is cheaper than handing it to the workers
+static constexpr uint32_t ParallelCullSize = 8192;
+static const char* CullShaderPath = "resource/shaders/cullComp.spv";
+
+//cooked cache layout: header, then 16 byte aligned sections for vertices, indices, nodes (parents first),
+//draw items, materials, pbr factors, texture sources and a string table of image uris followed by source files
+static const uint32_t CookedMagic = 0x43544C47; //"GLTC"
+static const uint32_t CookedVersion = 4;
+
+struct CookedHeader
 {
-	bool isLoaded = m_Contenxt.LoadASCIIFromFile(&m_Model, &err, &warning, filaname);
-	if (!isLoaded)
+	uint32_t Magic;
+	uint32_t Version;
+	uint64_t SourceHash;
+	//record sizes of the writer, a cache from a build with a different struct layout is rejected
+	uint32_t VertexSize;
+	uint32_t NodeSize;
+	uint32_t DrawSize;
+	uint32_t MaterialSize;
+	uint32_t FactorSize;
+	uint32_t TextureSize;
+	uint32_t VertexCount;
+	uint32_t IndexCount;
+	uint32_t NodeCount;
+	uint32_t DrawCount;
+	uint32_t MaterialCount;
+	uint32_t TextureCount;
+	uint32_t ImageCount;
+	uint32_t DependencyCount;
+	uint64_t VertexOffset;
+	uint64_t IndexOffset;
+	uint64_t NodeOffset;
+	uint64_t DrawOffset;
+	uint64_t MaterialOffset;
+	uint64_t FactorOffset;
+	uint64_t TextureOffset;
+	uint64_t StringOffset;
+	uint64_t StringSize;
+};
+
+struct CookedNode
+{
+	glm::mat4 Local;
+	glm::vec3 Translation;
+	glm::quat Rotation;
+	glm::vec3 Scale;
+	int32_t Parent;
+};
+
+//hashes name, size and write time of every source file, so validating the cache never has to open them
+static bool HashSources(const std::string& baseDir, const std::vector<std::string>& files, uint64_t* hash)
+{
+	uint64_t result = HashBytes(HashSeed, &CookedVersion, sizeof(CookedVersion));
+	for (auto& file : files)
 	{
-		throw std::runtime_error("error load gtTF!");
+		std::error_code error;
+		std::filesystem::path path = std::filesystem::path(baseDir) / file;
+		uint64_t size = std::filesystem::file_size(path, error);
+		if (error)
+		{
+			return false;
+		}
+		int64_t time = std::filesystem::last_write_time(path, error).time_since_epoch().count();
+		if (error)
+		{
+			return false;
+		}
+		result = HashBytes(result, file.data(), file.size());
+		result = HashBytes(result, &size, sizeof(size));
+		result = HashBytes(result, &time, sizeof(time));
+	}
+	*hash = result;
+	return true;
+}
+
+//a section of count records must lie inside the file and start on its 16 byte boundary
+static bool CheckSection(uint64_t offset, uint64_t count, uint64_t recordSize, uint64_t fileSize)
+{
+	if (offset % 16 != 0 || offset > fileSize || recordSize == 0)
+	{
+		return false;
 	}
+	return count <= (fileSize - offset) / recordSize;
+}
+
+static uint64_t AppendSection(std::vector<uint8_t>& blob, const void* data, size_t size)
+{
+	blob.resize((blob.size() + 15) & ~size_t(15));
+	uint64_t offset = blob.size();
+	const uint8_t* bytes = static_cast<const uint8_t*>(data);
+	blob.insert(blob.end(), bytes, bytes + size);
+	return offset;
+}
+
+static void AppendString(std::vector<uint8_t>& blob, const std::string& value)
+{
+	uint32_t length = static_cast<uint32_t>(value.size());
+	const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&length);
+	blob.insert(blob.end(), bytes, bytes + sizeof(length));
+	blob.insert(blob.end(), value.begin(), value.end());
+}
+
+static bool ReadString(const uint8_t*& cursor, const uint8_t* end, std::string* value)
+{
+	uint32_t length = 0;
+	if (end - cursor < static_cast<ptrdiff_t>(sizeof(length)))
+	{
+		return false;
+	}
+	memcpy(&length, cursor, sizeof(length));
+	cursor += sizeof(length);
+	if (end - cursor < static_cast<ptrdiff_t>(length))
+	{
+		return false;
+	}
+	value->assign(reinterpret_cast<const char*>(cursor), length);
+	cursor += length;
+	return true;
+}
+
+void GlTFModel::LoadModel(Device& device, const std::string& filaname, uint32_t framesInFlight)
+{
 	m_Device = device;
+	m_FramesInFlight = framesInFlight;
+	const vk::PhysicalDeviceVulkan12Features& features12 = m_Device.GetEnabledFeatures12();
+	m_Bindless = m_Bindless && features12.runtimeDescriptorArray && features12.descriptorBindingPartiallyBound && features12.descriptorBindingSampledImageUpdateAfterBind;
+	m_BaseDir = std::filesystem::path(filaname).parent_path().string();
+	std::string cookedPath = filaname + ".cooked";
+	if (!LoadCooked(cookedPath))
+	{
+		ParseGlTF(filaname);
+		CreateGeometryBuffers(m_Vertices.data(), sizeof(GlTFModel::Vertex) * m_Vertices.size(), m_Indices.data(), sizeof(uint32_t) * m_Indices.size());
+		WriteCooked(cookedPath);
+	}
 	LoadImages();
+
+	m_UniformBuffer.Create(m_Device, vk::BufferUsageFlagBits::eUniformBuffer, sizeof(PBRFactor), vk::SharingMode::eExclusive, vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent, nullptr);
+	m_UniformBuffer.Map();
+
+	//read in the vertex shader as modelMatrix[gl_InstanceIndex], firstInstance carries the draw index
+	vk::DeviceSize alignment = m_Device.GetProperties().limits.minStorageBufferOffsetAlignment;
+	m_DrawStride = (sizeof(glm::mat4) * (std::max)(m_DrawList.size(), size_t(1)) + alignment - 1) / alignment * alignment;
+	m_DrawBuffer.Create(m_Device, vk::BufferUsageFlagBits::eStorageBuffer, m_DrawStride * m_FramesInFlight, vk::SharingMode::eExclusive, vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent, nullptr);
+	m_DrawBuffer.Map();
+	m_SliceVersions.assign(m_FramesInFlight, 0);
+	
+	BuildDescriptorSets();
+	BuildIndirectCommands();
+	//all images and geometry go to the GPU as a single batch
+	m_UploadTicket = m_Device.GetUploadContext().Submit();
+}
+
+void GlTFModel::ParseGlTF(const std::string& filename)
+{
+	bool isLoaded = m_Contenxt.LoadASCIIFromFile(&m_Model, &err, &warning, filename);
+	if (!isLoaded)
+	{
+		throw std::runtime_error("error load gtTF!");
+	}
 	LoadMaterials();
 	loadTextures();
 	tinygltf::Scene& scene = m_Model.scenes[0];
 	for (uint32_t i = 0; i < scene.nodes.size(); i++)
 	{
 		tinygltf::Node& node = m_Model.nodes[scene.nodes[i]];
-		LoadNode(node, nullptr);
+		LoadNode(node, NodeHierarchy::NoParent);
 	}
 
-	//buffers
-	vk::DeviceSize vertexBufferSize = sizeof(GlTFModel::Vertex) * m_Vertices.size();
-	Buffer vertexStagingBuffer;
-	vertexStagingBuffer.Create(m_Device, vk::BufferUsageFlagBits::eTransferSrc, vertexBufferSize, vk::SharingMode::eExclusive, vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent, m_Vertices.data());
-	m_VertexBuffer.Create(m_Device, vk::BufferUsageFlagBits::eVertexBuffer | vk::BufferUsageFlagBits::eTransferDst, vertexBufferSize, vk::SharingMode::eExclusive, vk::MemoryPropertyFlagBits::eDeviceLocal, nullptr);
-	Buffer::CopyBuffer(vertexStagingBuffer.m_Buffer, 0, m_VertexBuffer.m_Buffer, 0, vertexBufferSize, m_Device.GetGraphicQueue(), m_Device.GetCommandManager());
+	//external files are recorded so the cooked copy can be validated and images loaded without the json
+	m_Dependencies.push_back(std::filesystem::path(filename).filename().string());
+	for (auto& buffer : m_Model.buffers)
+	{
+		std::string uri;
+		if (!buffer.uri.empty() && !tinygltf::IsDataURI(buffer.uri) && tinygltf::URIDecode(buffer.uri, &uri, nullptr))
+		{
+			m_Dependencies.push_back(uri);
+		}
+	}
+	m_ImageUris.resize(m_Model.images.size());
+	for (uint32_t i = 0; i < m_Model.images.size(); i++)
+	{
+		tinygltf::Image& gltfImage = m_Model.images[i];
+		if (gltfImage.image.empty() && !gltfImage.uri.empty())
+		{
+			tinygltf::URIDecode(gltfImage.uri, &m_ImageUris[i], nullptr);
+		}
+	}
+}
 
+bool GlTFModel::LoadCooked(const std::string& cookedPath)
+{
+	MappedFile file;
+	if (!file.Open(cookedPath) || file.GetSize() < sizeof(CookedHeader))
+	{
+		return false;
+	}
+	const uint8_t* data = file.GetData();
+	const uint8_t* end = data + file.GetSize();
+	CookedHeader header;
+	memcpy(&header, data, sizeof(header));
+	if (header.Magic != CookedMagic || header.Version != CookedVersion)
+	{
+		return false;
+	}
+	if (header.VertexSize != sizeof(GlTFModel::Vertex) || header.NodeSize != sizeof(CookedNode) || header.DrawSize != sizeof(DrawItem) ||
+		header.MaterialSize != sizeof(Material) || header.FactorSize != sizeof(PBRFactor) || header.TextureSize != sizeof(TextureIndex))
+	{
+		return false;
+	}
+	uint64_t fileSize = file.GetSize();
+	if (!CheckSection(header.VertexOffset, header.VertexCount, sizeof(GlTFModel::Vertex), fileSize) ||
+		!CheckSection(header.IndexOffset, header.IndexCount, sizeof(uint32_t), fileSize) ||
+		!CheckSection(header.NodeOffset, header.NodeCount, sizeof(CookedNode), fileSize) ||
+		!CheckSection(header.DrawOffset, header.DrawCount, sizeof(DrawItem), fileSize) ||
+		!CheckSection(header.MaterialOffset, header.MaterialCount, sizeof(Material), fileSize) ||
+		!CheckSection(header.FactorOffset, header.MaterialCount, sizeof(PBRFactor), fileSize) ||
+		!CheckSection(header.TextureOffset, header.TextureCount, sizeof(TextureIndex), fileSize) ||
+		!CheckSection(header.StringOffset, header.StringSize, 1, fileSize))
+	{
+		return false;
+	}
 
-	vk::DeviceSize indexBufferSize = sizeof(uint32_t) * m_Indices.size();
-	Buffer indexStagingBuffer;
-	indexStagingBuffer.Create(m_Device, vk::BufferUsageFlagBits::eTransferSrc, indexBufferSize, vk::SharingMode::eExclusive, vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent, m_Indices.data());
-	m_IndexBuffer.Create(m_Device, vk::BufferUsageFlagBits::eIndexBuffer | vk::BufferUsageFlagBits::eTransferDst, indexBufferSize, vk::SharingMode::eExclusive, vk::MemoryPropertyFlagBits::eDeviceLocal, nullptr);
-	Buffer::CopyBuffer(indexStagingBuffer.m_Buffer, 0, m_IndexBuffer.m_Buffer, 0, indexBufferSize, m_Device.GetGraphicQueue(), m_Device.GetCommandManager());
+	std::vector<std::string> imageUris(header.ImageCount);
+	std::vector<std::string> dependencies(header.DependencyCount);
+	const uint8_t* cursor = data + header.StringOffset;
+	for (auto& uri : imageUris)
+	{
+		if (!ReadString(cursor, end, &uri))
+		{
+			return false;
+		}
+	}
+	for (auto& dependency : dependencies)
+	{
+		if (!ReadString(cursor, end, &dependency))
+		{
+			return false;
+		}
+	}
+	uint64_t hash = 0;
+	if (!HashSources(m_BaseDir, dependencies, &hash) || hash != header.SourceHash)
+	{
+		return false;
+	}
 
-	m_UniformBuffer.Create(m_Device, vk::BufferUsageFlagBits::eUniformBuffer, sizeof(PBRFactor), vk::SharingMode::eExclusive, vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent, nullptr);
-	m_UniformBuffer.Map();
+	//UpdateWorld resolves in one pass and indexes parents directly, a bad reference must not reach it
+	const CookedNode* cookedNodes = reinterpret_cast<const CookedNode*>(data + header.NodeOffset);
+	for (uint32_t i = 0; i < header.NodeCount; i++)
+	{
+		int32_t parent = cookedNodes[i].Parent;
+		if (parent != NodeHierarchy::NoParent && (parent < 0 || static_cast<uint32_t>(parent) >= i))
+		{
+			return false;
+		}
+	}
+	const DrawItem* drawItems = reinterpret_cast<const DrawItem*>(data + header.DrawOffset);
+	for (uint32_t i = 0; i < header.DrawCount; i++)
+	{
+		if (drawItems[i].NodeIndex >= header.NodeCount)
+		{
+			return false;
+		}
+	}
+
+	m_ImageUris = std::move(imageUris);
+	m_Dependencies = std::move(dependencies);
+	m_Materials.resize(header.MaterialCount);
+	memcpy(m_Materials.data(), data + header.MaterialOffset, sizeof(Material) * header.MaterialCount);
+	m_PBRFactors.resize(header.MaterialCount);
+	memcpy(m_PBRFactors.data(), data + header.FactorOffset, sizeof(PBRFactor) * header.MaterialCount);
+	m_TextureIndices.resize(header.TextureCount);
+	memcpy(m_TextureIndices.data(), data + header.TextureOffset, sizeof(TextureIndex) * header.TextureCount);
 
-	m_ModelMatrixs.resize(m_Materials.size());
-	for (uint32_t i = 0; i < m_Materials.size(); i++)
+	for (uint32_t i = 0; i < header.NodeCount; i++)
 	{
-		m_ModelMatrixs[i].Create(m_Device, vk::BufferUsageFlagBits::eUniformBuffer, sizeof(ModelMatrix), vk::SharingMode::eExclusive, vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent, nullptr);
-		m_ModelMatrixs[i].Map();
+		m_Hierarchy.Add(cookedNodes[i].Parent, cookedNodes[i].Local);
+		m_Hierarchy.Translations[i] = cookedNodes[i].Translation;
+		m_Hierarchy.Rotations[i] = cookedNodes[i].Rotation;
+		m_Hierarchy.Scales[i] = cookedNodes[i].Scale;
 	}
-	
-	BuildDescriptorSets();
+	m_DrawList.assign(drawItems, drawItems + header.DrawCount);
+
+	//geometry goes from the mapping straight into the staging ring
+	CreateGeometryBuffers(data + header.VertexOffset, sizeof(GlTFModel::Vertex) * header.VertexCount, data + header.IndexOffset, sizeof(uint32_t) * header.IndexCount);
+	return true;
+}
+
+void GlTFModel::WriteCooked(const std::string& cookedPath)
+{
+	//embedded images only live in the json, such models are always parsed
+	for (uint32_t i = 0; i < m_ImageUris.size(); i++)
+	{
+		if (m_ImageUris[i].empty())
+		{
+			return;
+		}
+	}
+	CookedHeader header = {};
+	header.Magic = CookedMagic;
+	header.Version = CookedVersion;
+	header.VertexSize = sizeof(GlTFModel::Vertex);
+	header.NodeSize = sizeof(CookedNode);
+	header.DrawSize = sizeof(DrawItem);
+	header.MaterialSize = sizeof(Material);
+	header.FactorSize = sizeof(PBRFactor);
+	header.TextureSize = sizeof(TextureIndex);
+	if (!HashSources(m_BaseDir, m_Dependencies, &header.SourceHash))
+	{
+		return;
+	}
+
+	std::vector<CookedNode> nodes(m_Hierarchy.Size());
+	for (uint32_t i = 0; i < nodes.size(); i++)
+	{
+		nodes[i].Local = m_Hierarchy.LocalMatrices[i];
+		nodes[i].Translation = m_Hierarchy.Translations[i];
+		nodes[i].Rotation = m_Hierarchy.Rotations[i];
+		nodes[i].Scale = m_Hierarchy.Scales[i];
+		nodes[i].Parent = m_Hierarchy.Parents[i];
+	}
+	header.VertexCount = static_cast<uint32_t>(m_Vertices.size());
+	header.IndexCount = static_cast<uint32_t>(m_Indices.size());
+	header.NodeCount = static_cast<uint32_t>(nodes.size());
+	header.DrawCount = static_cast<uint32_t>(m_DrawList.size());
+	header.MaterialCount = static_cast<uint32_t>(m_Materials.size());
+	header.TextureCount = static_cast<uint32_t>(m_TextureIndices.size());
+	header.ImageCount = static_cast<uint32_t>(m_ImageUris.size());
+	header.DependencyCount = static_cast<uint32_t>(m_Dependencies.size());
+
+	std::vector<uint8_t> blob(sizeof(CookedHeader));
+	header.VertexOffset = AppendSection(blob, m_Vertices.data(), sizeof(GlTFModel::Vertex) * m_Vertices.size());
+	header.IndexOffset = AppendSection(blob, m_Indices.data(), sizeof(uint32_t) * m_Indices.size());
+	header.NodeOffset = AppendSection(blob, nodes.data(), sizeof(CookedNode) * nodes.size());
+	header.DrawOffset = AppendSection(blob, m_DrawList.data(), sizeof(DrawItem) * m_DrawList.size());
+	header.MaterialOffset = AppendSection(blob, m_Materials.data(), sizeof(Material) * m_Materials.size());
+	header.FactorOffset = AppendSection(blob, m_PBRFactors.data(), sizeof(PBRFactor) * m_PBRFactors.size());
+	header.TextureOffset = AppendSection(blob, m_TextureIndices.data(), sizeof(TextureIndex) * m_TextureIndices.size());
+	header.StringOffset = AppendSection(blob, nullptr, 0);
+	for (auto& uri : m_ImageUris)
+	{
+		AppendString(blob, uri);
+	}
+	for (auto& dependency : m_Dependencies)
+	{
+		AppendString(blob, dependency);
+	}
+	header.StringSize = blob.size() - header.StringOffset;
+	memcpy(blob.data(), &header, sizeof(header));
+
+	//write aside and rename, a crash mid-write must not leave a valid looking cache
+	std::string tempPath = cookedPath + ".tmp";
+	{
+		std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+		if (!out.write(reinterpret_cast<const char*>(blob.data()), blob.size()))
+		{
+			return;
+		}
+	}
+	std::error_code error;
+	std::filesystem::rename(tempPath, cookedPath, error);
+	if (error)
+	{
+		std::filesystem::remove(tempPath, error);
+	}
+}
+
+void GlTFModel::CreateGeometryBuffers(const void* vertices, vk::DeviceSize vertexSize, const void* indices, vk::DeviceSize indexSize)
+{
+	StagingRange vertexStaging = m_Device.GetStagingRing().Upload(vertices, vertexSize);
+	m_VertexBuffer.Create(m_Device, vk::BufferUsageFlagBits::eVertexBuffer | vk::BufferUsageFlagBits::eTransferDst, vertexSize, vk::SharingMode::eExclusive, vk::MemoryPropertyFlagBits::eDeviceLocal, nullptr);
+	Buffer::CopyBuffer(m_Device.GetUploadContext().GetCommandBuffer(), vertexStaging.Buffer, vertexStaging.Offset, m_VertexBuffer.m_Buffer, 0, vertexSize);
+
+	StagingRange indexStaging = m_Device.GetStagingRing().Upload(indices, indexSize);
+	m_IndexBuffer.Create(m_Device, vk::BufferUsageFlagBits::eIndexBuffer | vk::BufferUsageFlagBits::eTransferDst, indexSize, vk::SharingMode::eExclusive, vk::MemoryPropertyFlagBits::eDeviceLocal, nullptr);
+	Buffer::CopyBuffer(m_Device.GetUploadContext().GetCommandBuffer(), indexStaging.Buffer, indexStaging.Offset, m_IndexBuffer.m_Buffer, 0, indexSize);
 }
 
 void GlTFModel::LoadImages()
 {
-	uint32_t imageCount = m_Model.images.size();
+	//decoded rgba pixels, either owned by stb or by Expanded
+	struct DecodedImage
+	{
+		stbi_uc* Pixels = nullptr;
+		std::vector<uint8_t> Expanded;
+		const uint8_t* Data = nullptr;
+		int Width = 0;
+		int Height = 0;
+	};
+	uint32_t imageCount = m_ImageUris.size();
 	m_Textures.resize(imageCount);
+	std::vector<DecodedImage> decoded(imageCount);
+	std::mutex readyMutex;
+	std::vector<uint32_t> ready;
+	JobSystem& jobs = JobSystem::Get();
+	JobCounter counter;
 	for (uint32_t i = 0; i < imageCount; i++)
 	{
-		tinygltf::Image& gltfImage = m_Model.images[i];
-		unsigned char* bufferData = nullptr;
-		vk::DeviceSize bufferSize = 0;
-		int pixelCount = 0;
-		bool deleteBuffer = false;
-		if (gltfImage.component == 3)
-		{
-			deleteBuffer = true;
-			pixelCount = gltfImage.width * gltfImage.height;
-			bufferSize = pixelCount * 4;
-			bufferData = new unsigned char[bufferSize];
-			unsigned char* rgba = bufferData;
-			unsigned char* rgb = &gltfImage.image[0];
-			for (uint32_t j = 0; j < pixelCount; j++)
+		jobs.Submit([this, i, &decoded, &readyMutex, &ready]() {
+			DecodedImage& image = decoded[i];
+			if (!m_ImageUris[i].empty())
+			{
+				std::string path = (std::filesystem::path(m_BaseDir) / m_ImageUris[i]).string();
+				int channels = 0;
+				stbi_set_flip_vertically_on_load_thread(0);
+				image.Pixels = stbi_load(path.c_str(), &image.Width, &image.Height, &channels, STBI_rgb_alpha);
+				image.Data = image.Pixels;
+			}
+			else
 			{
-				memcpy(rgba, rgb, sizeof(unsigned char) * 3);
-				rgba += 4;
-				rgb  += 3;
+				tinygltf::Image& gltfImage = m_Model.images[i];
+				image.Width = gltfImage.width;
+				image.Height = gltfImage.height;
+				if (gltfImage.component == 3)
+				{
+					image.Expanded.resize(static_cast<size_t>(gltfImage.width) * gltfImage.height * 4);
+					ExpandRGBToRGBA(gltfImage.image.data(), image.Expanded.data(), static_cast<size_t>(gltfImage.width) * gltfImage.height);
+					image.Data = image.Expanded.data();
+				}
+				else
+				{
+					image.Data = gltfImage.image.data();
+				}
 			}
+			std::lock_guard<std::mutex> lock(readyMutex);
+			ready.push_back(i);
+		}, &counter);
+	}
+
+	//upload each image as soon as its decode lands, recording stays on this thread
+	std::string failed;
+	uint32_t uploaded = 0;
+	std::vector<uint32_t> batch;
+	while (uploaded < imageCount)
+	{
+		//read before the swap, so once every decode is done its image is in this batch
+		bool finished = counter.Pending.load(std::memory_order_acquire) == 0;
+		{
+			std::lock_guard<std::mutex> lock(readyMutex);
+			batch.swap(ready);
 		}
-		else
+		if (batch.empty())
 		{
-			bufferData = &gltfImage.image[0];
-			bufferSize = gltfImage.image.size() * sizeof(unsigned char);
+			//a decode that threw never becomes ready, Wait rethrows it
+			if (finished)
+			{
+				break;
+			}
+			if (!jobs.RunPending())
+			{
+				std::this_thread::yield();
+			}
+			continue;
 		}
-		m_Textures[i].FromBuffer(m_Device, bufferData, bufferSize, vk::Format::eR8G8B8A8Srgb, gltfImage.width, gltfImage.height, false);
-		if (deleteBuffer)
+		for (uint32_t index : batch)
 		{
-			delete[] bufferData;
+			DecodedImage& image = decoded[index];
+			if (image.Data)
+			{
+				vk::DeviceSize size = static_cast<vk::DeviceSize>(image.Width) * image.Height * 4;
+				m_Textures[index].FromBuffer(m_Device, const_cast<uint8_t*>(image.Data), size, vk::Format::eR8G8B8A8Srgb, image.Width, image.Height, false);
+			}
+			else
+			{
+				failed = m_ImageUris[index];
+			}
+			if (image.Pixels)
+			{
+				stbi_image_free(image.Pixels);
+			}
+			image = DecodedImage();
+			uploaded++;
 		}
+		batch.clear();
+	}
+	jobs.Wait(counter);
+	if (!failed.empty())
+	{
+		throw std::runtime_error("failed to load glTF image " + failed);
 	}
 }
 
@@ -141,34 +547,19 @@ void GlTFModel::loadTextures()
 	}
 }
 
-void GlTFModel::LoadNode(const tinygltf::Node& inputNode, GlTFModel::Node* parent)
+void GlTFModel::LoadNode(const tinygltf::Node& inputNode, int32_t parent)
 {
-	GlTFModel::Node* node = new GlTFModel::Node();
-	node->ModelMatrix = glm::mat4(1.0f);
-	node->Parent = parent;
-	if (inputNode.translation.size() == 3)
-	{
-		node->ModelMatrix = glm::translate(node->ModelMatrix, glm::vec3(glm::make_vec3(inputNode.translation.data())));
-	}
-	if (inputNode.rotation.size() == 4)
-	{
-		glm::quat q = glm::make_quat(inputNode.rotation.data());
-		node->ModelMatrix *= glm::mat4(q);
-	}
-	if (inputNode.scale.size() == 3)
-	{
-		node->ModelMatrix = glm::scale(node->ModelMatrix, glm::vec3(glm::make_vec3(inputNode.scale.data())));
-	}
+	uint32_t nodeIndex = m_Hierarchy.Add(parent, glm::mat4(1.0f));
 	if (inputNode.matrix.size() > 0)
 	{
-		node->ModelMatrix = glm::make_mat4(inputNode.matrix.data());
+		m_Hierarchy.SetLocal(nodeIndex, glm::make_mat4(inputNode.matrix.data()));
 	}
-	if (inputNode.children.size() > 0)
+	else
 	{
-		for (uint32_t i = 0; i < inputNode.children.size(); i++)
-		{
-			LoadNode(m_Model.nodes[inputNode.children[i]], node);
-		}
+		glm::vec3 translation = inputNode.translation.size() == 3 ? glm::vec3(glm::make_vec3(inputNode.translation.data())) : glm::vec3(0.0f);
+		glm::quat rotation = inputNode.rotation.size() == 4 ? glm::quat(glm::make_quat(inputNode.rotation.data())) : glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
+		glm::vec3 scale = inputNode.scale.size() == 3 ? glm::vec3(glm::make_vec3(inputNode.scale.data())) : glm::vec3(1.0f);
+		m_Hierarchy.SetLocal(nodeIndex, translation, rotation, scale);
 	}
 	if (inputNode.mesh > -1)
 	{
@@ -261,79 +652,452 @@ void GlTFModel::LoadNode(const tinygltf::Node& inputNode, GlTFModel::Node* paren
 					}
 				}
 			}
+			//bounds from the vertices this primitive appended
+			glm::vec3 boundsMin(0.0f);
+			glm::vec3 boundsMax(0.0f);
+			if (m_Vertices.size() > vertexStart)
+			{
+				boundsMin = m_Vertices[vertexStart].Pos;
+				boundsMax = m_Vertices[vertexStart].Pos;
+				for (size_t v = vertexStart + 1; v < m_Vertices.size(); v++)
+				{
+					boundsMin = glm::min(boundsMin, m_Vertices[v].Pos);
+					boundsMax = glm::max(boundsMax, m_Vertices[v].Pos);
+				}
+			}
 			Primitive curPrimitive;
 			curPrimitive.FirstIndex = firstIndex;
 			curPrimitive.IndexCount = indexCount;
 			curPrimitive.MaterialIndex = primitive.material;
-			node->NodeMesh.Primitives.push_back(curPrimitive);
+			if (indexCount > 0)
+			{
+				m_DrawList.push_back({ nodeIndex, curPrimitive, boundsMin, boundsMax });
+			}
 		}
 	}
 
-	if (parent)
+	//children after the node itself keeps parents ahead of their children
+	for (uint32_t i = 0; i < inputNode.children.size(); i++)
+	{
+		LoadNode(m_Model.nodes[inputNode.children[i]], static_cast<int32_t>(nodeIndex));
+	}
+}
+
+void GlTFModel::Draw(vk::CommandBuffer command, PipeLineLayout& layout, uint32_t frameIndex, vk::Pipeline pipeline)
+{
+	UpdateDrawMatrices(frameIndex);
+	UpdateMaterials(frameIndex);
+	uint32_t dynamicOffset = static_cast<uint32_t>(m_DrawStride * frameIndex);
+	if (m_Indirect)
+	{
+		WriteVisibleCommands(frameIndex);
+		DrawIndirect(command, layout, frameIndex, pipeline);
+		return;
+	}
+	BuildDrawPackets(layout, pipeline);
+	BindGeometry(command, layout, frameIndex);
+	m_DrawPackets.Record(command, layout.GetPipelineLayout(), 1, { dynamicOffset }, m_Bindless ? vk::ShaderStageFlagBits::eFragment : vk::ShaderStageFlags());
+}
+
+void GlTFModel::DrawParallel(vk::CommandBuffer primary, const vk::CommandBufferInheritanceInfo& inheritance, const std::function<void(vk::CommandBuffer)>& bindState, PipeLineLayout& layout, uint32_t frameIndex, vk::Pipeline pipeline)
+{
+	UpdateDrawMatrices(frameIndex);
+	UpdateMaterials(frameIndex);
+	ParallelRecorder& recorder = m_Device.GetParallelRecorder();
+	if (m_Indirect)
+	{
+		WriteVisibleCommands(frameIndex);
+		//a handful of commands, not worth more than one secondary
+		recorder.Record(primary, inheritance, 1, 1, [&](vk::CommandBuffer command, uint32_t, uint32_t, uint32_t) {
+			bindState(command);
+			DrawIndirect(command, layout, frameIndex, pipeline);
+		});
+		return;
+	}
+	uint32_t dynamicOffset = static_cast<uint32_t>(m_DrawStride * frameIndex);
+	BuildDrawPackets(layout, pipeline);
+	m_DrawPackets.RecordParallel(recorder, primary, inheritance, [&](vk::CommandBuffer command) {
+		bindState(command);
+		BindGeometry(command, layout, frameIndex);
+	}, layout.GetPipelineLayout(), 1, { dynamicOffset }, m_Bindless ? vk::ShaderStageFlagBits::eFragment : vk::ShaderStageFlags());
+}
+
+void GlTFModel::CullVisible()
+{
+	m_Visible.clear();
+	if (m_Culling && m_HasFrustum)
 	{
-		parent->Children.push_back(node);
+		uint32_t count = static_cast<uint32_t>(m_WorldBounds.Size());
+		if (count < ParallelCullSize)
+		{
+			CullBounds(m_Frustum, m_WorldBounds, m_Visible);
+		}
+		else
+		{
+			//each range culls into its own list, concatenated in range order so the result matches the serial cull
+			m_ChunkVisible.resize((count + ParallelCullSize - 1) / ParallelCullSize);
+			JobSystem::Get().ParallelFor(count, ParallelCullSize, [this](uint32_t first, uint32_t last) {
+				std::vector<uint32_t>& chunk = m_ChunkVisible[first / ParallelCullSize];
+				chunk.clear();
+				CullBounds(m_Frustum, m_WorldBounds, first, last, chunk);
+			});
+			for (auto& chunk : m_ChunkVisible)
+			{
+				m_Visible.insert(m_Visible.end(), chunk.begin(), chunk.end());
+			}
+		}
 	}
 	else
 	{
-		m_Nodes.push_back(node);
+		for (uint32_t i = 0; i < m_DrawList.size(); i++)
+		{
+			m_Visible.push_back(i);
+		}
 	}
+	m_CullStats.Tested = static_cast<uint32_t>(m_DrawList.size());
+	m_CullStats.Visible = static_cast<uint32_t>(m_Visible.size());
+	m_CullStats.Culled = m_CullStats.Tested - m_CullStats.Visible;
 }
 
-void GlTFModel::Draw(vk::CommandBuffer command, PipeLineLayout& layout)
+void GlTFModel::BuildDrawPackets(PipeLineLayout& layout, vk::Pipeline pipeline)
+{
+	CullVisible();
+	m_DrawPackets.Reset();
+	for (uint32_t i : m_Visible)
+	{
+		const DrawItem& item = m_DrawList[i];
+		//bindless draws all share set 1 and only differ in the pushed material index
+		vk::DescriptorSet set = layout.GetDescriptorSet(1, m_Bindless ? 0 : item.Prim.MaterialIndex);
+		m_DrawPackets.Add(pipeline, set, item.Prim.MaterialIndex, item.Prim.FirstIndex, item.Prim.IndexCount, i);
+	}
+	m_DrawPackets.Sort();
+}
+
+void GlTFModel::WriteVisibleCommands(uint32_t frameIndex)
+{
+	m_CpuCulled = false;
+	if (m_GpuCulled)
+	{
+		return;
+	}
+	CullVisible();
+	if (!m_Culling || !m_HasFrustum)
+	{
+		return;
+	}
+	m_VisibleFlags.assign(m_DrawList.size(), 0);
+	for (uint32_t i : m_Visible)
+	{
+		m_VisibleFlags[i] = 1;
+	}
+	//this frame's slice is not read by any frame still in flight
+	vk::DrawIndexedIndirectCommand* commands = reinterpret_cast<vk::DrawIndexedIndirectCommand*>(static_cast<char*>(m_VisibleCommandBuffer.mapped) + m_VisibleCommandStride * frameIndex);
+	for (uint32_t b = 0; b < m_IndirectBatches.size(); b++)
+	{
+		const IndirectBatch& batch = m_IndirectBatches[b];
+		uint32_t count = 0;
+		for (uint32_t i = batch.FirstCommand; i < batch.FirstCommand + batch.CommandCount; i++)
+		{
+			//firstInstance is the draw item index
+			if (m_VisibleFlags[m_IndirectCommands[i].firstInstance])
+			{
+				commands[batch.FirstCommand + count++] = m_IndirectCommands[i];
+			}
+		}
+		m_VisibleBatchCounts[b] = count;
+	}
+	m_CpuCulled = true;
+}
+
+void GlTFModel::BindGeometry(vk::CommandBuffer command, PipeLineLayout& layout, uint32_t frameIndex)
 {
 	vk::DeviceSize offset = 0.0f;
 	command.bindVertexBuffers(0, 1, &m_VertexBuffer.m_Buffer, &offset);
 	command.bindIndexBuffer(m_IndexBuffer.m_Buffer, offset, vk::IndexType::eUint32);
-	for (auto& node : m_Nodes)
+	if (m_Bindless)
+	{
+		vk::DescriptorSet bindlessSet = layout.GetDescriptorSet(BindlessSetIndex, frameIndex);
+		command.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, layout.GetPipelineLayout(), BindlessSetIndex, 1, &bindlessSet, 0, nullptr);
+	}
+}
+
+void GlTFModel::UpdateDrawMatrices(uint32_t frameIndex)
+{
+	if (m_Hierarchy.UpdateWorld() || m_WorldBounds.Size() != m_DrawList.size())
+	{
+		UpdateWorldBounds();
+		m_TransformVersion++;
+	}
+	//a static scene leaves every slice as it is, only moved nodes cost CPU time
+	if (m_SliceVersions[frameIndex] == m_TransformVersion)
+	{
+		return;
+	}
+	//this frame's slice is not read by any frame still in flight
+	glm::mat4* drawMatrices = reinterpret_cast<glm::mat4*>(static_cast<char*>(m_DrawBuffer.mapped) + m_DrawStride * frameIndex);
+	for (uint32_t i = 0; i < m_DrawList.size(); i++)
+	{
+		drawMatrices[i] = m_Hierarchy.WorldMatrices[m_DrawList[i].NodeIndex];
+	}
+	m_SliceVersions[frameIndex] = m_TransformVersion;
+}
+
+void GlTFModel::UpdateMaterials(uint32_t frameIndex)
+{
+	if (!m_Bindless || m_MaterialSliceVersions[frameIndex] == m_MaterialVersion)
+	{
+		return;
+	}
+	//same as the draw matrices, this frame's slice is not read by any frame still in flight
+	memcpy(static_cast<char*>(m_MaterialBuffer.mapped) + m_MaterialStride * frameIndex, m_GpuMaterials.data(), sizeof(GpuMaterial) * m_GpuMaterials.size());
+	m_MaterialSliceVersions[frameIndex] = m_MaterialVersion;
+}
+
+void GlTFModel::UpdateWorldBounds()
+{
+	m_WorldBounds.Resize(m_DrawList.size());
+	for (uint32_t i = 0; i < m_DrawList.size(); i++)
 	{
-		DrawNode(node, command, layout);
+		const DrawItem& item = m_DrawList[i];
+		m_WorldBounds.SetTransformed(i, item.BoundsMin, item.BoundsMax, m_Hierarchy.WorldMatrices[item.NodeIndex]);
 	}
 }
 
-void GlTFModel::DrawNode(Node* node, vk::CommandBuffer command, PipeLineLayout& layout)
+bool GlTFModel::SetIndirect(bool enable)
 {
-	glm::mat4 modelMatrix = node->ModelMatrix;
-	Node* parent = node->Parent;
-	while (parent)
+	//firstInstance carries the transform index, without it indirect draws can't find their matrix
+	m_Indirect = enable && m_Device.GetEnabledFeatures().drawIndirectFirstInstance && m_IndirectBuffer.m_Buffer;
+	return m_Indirect;
+}
+
+void GlTFModel::BuildIndirectCommands()
+{
+	if (m_DrawList.empty())
 	{
-		modelMatrix = parent->ModelMatrix * modelMatrix;
-		parent = parent->Parent;
+		return;
 	}
-	if (node->NodeMesh.Primitives.size() > 0)
+	//group draw items by material, the geometry is static so this happens once
+	std::vector<uint32_t> order(m_DrawList.size());
+	for (uint32_t i = 0; i < order.size(); i++)
 	{
-		for (uint32_t i = 0; i < node->NodeMesh.Primitives.size(); i++) 
+		order[i] = i;
+	}
+	std::stable_sort(order.begin(), order.end(), [this](uint32_t a, uint32_t b) {
+		return m_DrawList[a].Prim.MaterialIndex < m_DrawList[b].Prim.MaterialIndex;
+	});
+	std::vector<vk::DrawIndexedIndirectCommand>& commands = m_IndirectCommands;
+	commands.resize(order.size());
+	std::vector<GpuDrawObject> objects(order.size());
+	m_IndirectBatches.clear();
+	for (uint32_t i = 0; i < order.size(); i++)
+	{
+		const DrawItem& item = m_DrawList[order[i]];
+		commands[i].setIndexCount(item.Prim.IndexCount)
+				   .setInstanceCount(1)
+				   .setFirstIndex(item.Prim.FirstIndex)
+				   .setVertexOffset(0)
+				   .setFirstInstance(order[i]);
+		if (m_IndirectBatches.empty() || m_IndirectBatches.back().MaterialIndex != item.Prim.MaterialIndex)
 		{
-			auto& primitive = node->NodeMesh.Primitives[i];
-			if (primitive.IndexCount > 0)
-			{
-				//bindSets
-				uint32_t materialIndex = primitive.MaterialIndex;
-				vk::DescriptorSet set = layout.GetDescriptorSet(1, materialIndex);
-				command.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, layout.GetPipelineLayout(), 1, 1, &set, 0, nullptr);
-				UpdateUniforms(materialIndex, modelMatrix);
-				command.drawIndexed(primitive.IndexCount, 1, primitive.FirstIndex, 0, 0);
-			}
+			m_IndirectBatches.push_back({ item.Prim.MaterialIndex, i, 0 });
 		}
+		m_IndirectBatches.back().CommandCount++;
+		uint32_t batch = static_cast<uint32_t>(m_IndirectBatches.size() - 1);
+		objects[order[i]] = { glm::vec4(item.BoundsMin, 0.0f), glm::vec4(item.BoundsMax, 0.0f), item.Prim.IndexCount, item.Prim.FirstIndex, batch, m_IndirectBatches.back().FirstCommand };
 	}
-	for (auto& child : node->Children)
+
+	vk::DeviceSize size = sizeof(vk::DrawIndexedIndirectCommand) * commands.size();
+	StagingRange staging = m_Device.GetStagingRing().Upload(commands.data(), size);
+	m_IndirectBuffer.Create(m_Device, vk::BufferUsageFlagBits::eIndirectBuffer | vk::BufferUsageFlagBits::eTransferDst, size, vk::SharingMode::eExclusive, vk::MemoryPropertyFlagBits::eDeviceLocal, nullptr);
+	Buffer::CopyBuffer(m_Device.GetUploadContext().GetCommandBuffer(), staging.Buffer, staging.Offset, m_IndirectBuffer.m_Buffer, 0, size);
+
+	m_VisibleCommandStride = size;
+	m_VisibleCommandBuffer.Create(m_Device, vk::BufferUsageFlagBits::eIndirectBuffer, size * m_FramesInFlight, vk::SharingMode::eExclusive, vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent, nullptr);
+	m_VisibleCommandBuffer.Map();
+	m_VisibleBatchCounts.assign(m_IndirectBatches.size(), 0);
+	BuildCullPass(objects);
+}
+
+void GlTFModel::BuildCullPass(const std::vector<GpuDrawObject>& objects)
+{
+	//the compacted commands are drawn with a GPU side count, and more than one draw per call
+	if (!m_Device.GetEnabledFeatures12().drawIndirectCount || !m_Device.GetEnabledFeatures().multiDrawIndirect)
+	{
+		return;
+	}
+	//without the compiled shader Draw compacts the indirect commands on the CPU
+	if (!std::filesystem::exists(CullShaderPath))
 	{
-		DrawNode(child, command, layout);
+		std::cout << "gpu culling: " << CullShaderPath << " not found, culling the indirect commands on the CPU" << std::endl;
+		return;
 	}
+	vk::DeviceSize objectSize = sizeof(GpuDrawObject) * objects.size();
+	StagingRange staging = m_Device.GetStagingRing().Upload(objects.data(), objectSize);
+	m_ObjectBuffer.Create(m_Device, vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eTransferDst, objectSize, vk::SharingMode::eExclusive, vk::MemoryPropertyFlagBits::eDeviceLocal, nullptr);
+	Buffer::CopyBuffer(m_Device.GetUploadContext().GetCommandBuffer(), staging.Buffer, staging.Offset, m_ObjectBuffer.m_Buffer, 0, objectSize);
+
+	//each batch keeps its range of the static layout, the shader fills it from the front
+	vk::DeviceSize alignment = m_Device.GetProperties().limits.minStorageBufferOffsetAlignment;
+	m_CulledStride = (sizeof(vk::DrawIndexedIndirectCommand) * objects.size() + alignment - 1) / alignment * alignment;
+	m_CountStride = (sizeof(uint32_t) * m_IndirectBatches.size() + alignment - 1) / alignment * alignment;
+	vk::BufferUsageFlags usage = vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eIndirectBuffer | vk::BufferUsageFlagBits::eTransferDst;
+	m_CulledBuffer.Create(m_Device, usage, m_CulledStride * m_FramesInFlight, vk::SharingMode::eExclusive, vk::MemoryPropertyFlagBits::eDeviceLocal, nullptr);
+	m_CountBuffer.Create(m_Device, usage, m_CountStride * m_FramesInFlight, vk::SharingMode::eExclusive, vk::MemoryPropertyFlagBits::eDeviceLocal, nullptr);
+
+	DescriptorSetLayoutCreateInfo setLayout;
+	setLayout.Bindings = {
+		{ vk::DescriptorType::eStorageBuffer, vk::ShaderStageFlagBits::eCompute, 0 }, //draw objects
+		{ vk::DescriptorType::eStorageBufferDynamic, vk::ShaderStageFlagBits::eCompute, 1 }, //draw matrices
+		{ vk::DescriptorType::eStorageBufferDynamic, vk::ShaderStageFlagBits::eCompute, 2 }, //compacted commands
+		{ vk::DescriptorType::eStorageBufferDynamic, vk::ShaderStageFlagBits::eCompute, 3 }, //batch counts
+	};
+	setLayout.SetCount = 1;
+	setLayout.SetWriteData.push_back({
+		{ vk::DescriptorBufferInfo(m_ObjectBuffer.m_Buffer, 0, objectSize), {}, false },
+		{ vk::DescriptorBufferInfo(m_DrawBuffer.m_Buffer, 0, m_DrawStride), {}, false },
+		{ vk::DescriptorBufferInfo(m_CulledBuffer.m_Buffer, 0, m_CulledStride), {}, false },
+		{ vk::DescriptorBufferInfo(m_CountBuffer.m_Buffer, 0, m_CountStride), {}, false }
+	});
+	vk::PushConstantRange pushConstant(vk::ShaderStageFlagBits::eCompute, 0, sizeof(CullConstants));
+	m_CullLayout.Create(m_Device, { setLayout }, { pushConstant });
+	m_CullLayout.BuildAndUpdateSet();
+	m_CullPipeline = m_Device.GetPipelineRegistry().GetComputePipeline(CullShaderPath, m_CullLayout.GetPipelineLayout());
 }
 
-void GlTFModel::UpdateUniforms(uint32_t matId, glm::mat4 modelMatrix)
+void GlTFModel::Cull(vk::CommandBuffer command, uint32_t frameIndex)
 {
-	//m_UniformBuffer.CopyFrom(&m_PBRFactors[matId], sizeof(PBRFactor));
-	ModelMatrix mat;
-	mat.matrix = modelMatrix;
-	m_ModelMatrixs[matId].CopyFrom(&mat, sizeof(ModelMatrix));
+	m_GpuCulled = false;
+	if (!m_Indirect || !m_Culling || !m_HasFrustum || !m_CullPipeline)
+	{
+		return;
+	}
+	UpdateDrawMatrices(frameIndex);
+	m_Device.GetProfiler().BeginGpu(command, "cull");
+	vk::DeviceSize countOffset = m_CountStride * frameIndex;
+	command.fillBuffer(m_CountBuffer.m_Buffer, countOffset, sizeof(uint32_t) * m_IndirectBatches.size(), 0);
+
+	vk::BufferMemoryBarrier clearBarrier;
+	clearBarrier.sType = vk::StructureType::eBufferMemoryBarrier;
+	clearBarrier.setBuffer(m_CountBuffer.m_Buffer)
+				.setOffset(countOffset)
+				.setSize(m_CountStride)
+				.setSrcAccessMask(vk::AccessFlagBits::eTransferWrite)
+				.setDstAccessMask(vk::AccessFlagBits::eShaderRead | vk::AccessFlagBits::eShaderWrite)
+				.setSrcQueueFamilyIndex(VK_QUEUE_FAMILY_IGNORED)
+				.setDstQueueFamilyIndex(VK_QUEUE_FAMILY_IGNORED);
+	command.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eComputeShader, {}, 0, nullptr, 1, &clearBarrier, 0, nullptr);
+
+	CullConstants constants;
+	for (uint32_t i = 0; i < 6; i++)
+	{
+		constants.Planes[i] = m_Frustum.Planes[i];
+	}
+	constants.DrawCount = static_cast<uint32_t>(m_DrawList.size());
+	//dynamic offsets go in binding order: matrices, commands, counts
+	uint32_t dynamicOffsets[] = {
+		static_cast<uint32_t>(m_DrawStride * frameIndex),
+		static_cast<uint32_t>(m_CulledStride * frameIndex),
+		static_cast<uint32_t>(countOffset)
+	};
+	vk::DescriptorSet set = m_CullLayout.GetDescriptorSet(0);
+	command.bindPipeline(vk::PipelineBindPoint::eCompute, m_CullPipeline);
+	command.bindDescriptorSets(vk::PipelineBindPoint::eCompute, m_CullLayout.GetPipelineLayout(), 0, 1, &set, 3, dynamicOffsets);
+	command.pushConstants(m_CullLayout.GetPipelineLayout(), vk::ShaderStageFlagBits::eCompute, 0, sizeof(CullConstants), &constants);
+	command.dispatch((constants.DrawCount + 63) / 64, 1, 1);
+
+	vk::BufferMemoryBarrier barriers[2];
+	barriers[0].sType = vk::StructureType::eBufferMemoryBarrier;
+	barriers[0].setBuffer(m_CulledBuffer.m_Buffer)
+			   .setOffset(m_CulledStride * frameIndex)
+			   .setSize(m_CulledStride)
+			   .setSrcAccessMask(vk::AccessFlagBits::eShaderWrite)
+			   .setDstAccessMask(vk::AccessFlagBits::eIndirectCommandRead)
+			   .setSrcQueueFamilyIndex(VK_QUEUE_FAMILY_IGNORED)
+			   .setDstQueueFamilyIndex(VK_QUEUE_FAMILY_IGNORED);
+	barriers[1] = barriers[0];
+	barriers[1].setBuffer(m_CountBuffer.m_Buffer)
+			   .setOffset(countOffset)
+			   .setSize(m_CountStride);
+	command.pipelineBarrier(vk::PipelineStageFlagBits::eComputeShader, vk::PipelineStageFlagBits::eDrawIndirect, {}, 0, nullptr, 2, barriers, 0, nullptr);
+	m_Device.GetProfiler().EndGpu(command);
+	m_GpuCulled = true;
+}
+
+void GlTFModel::DrawIndirect(vk::CommandBuffer command, PipeLineLayout& layout, uint32_t frameIndex, vk::Pipeline pipeline)
+{
+	uint32_t dynamicOffset = static_cast<uint32_t>(m_DrawStride * frameIndex);
+	m_IndirectStats = DrawListStats();
+	command.bindPipeline(vk::PipelineBindPoint::eGraphics, pipeline);
+	m_IndirectStats.PipelineBinds++;
+	vk::DeviceSize offset = 0;
+	command.bindVertexBuffers(0, 1, &m_VertexBuffer.m_Buffer, &offset);
+	command.bindIndexBuffer(m_IndexBuffer.m_Buffer, offset, vk::IndexType::eUint32);
+	bool multiDraw = m_Device.GetEnabledFeatures().multiDrawIndirect;
+	uint32_t stride = sizeof(vk::DrawIndexedIndirectCommand);
+	if (m_Bindless)
+	{
+		vk::DescriptorSet sets[] = { layout.GetDescriptorSet(1), layout.GetDescriptorSet(BindlessSetIndex, frameIndex) };
+		command.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, layout.GetPipelineLayout(), 1, 2, sets, 1, &dynamicOffset);
+		m_IndirectStats.SetBinds++;
+	}
+	for (uint32_t b = 0; b < m_IndirectBatches.size(); b++)
+	{
+		const IndirectBatch& batch = m_IndirectBatches[b];
+		//the GPU count is an upper bound, a CPU culled batch can be empty
+		uint32_t drawCount = m_CpuCulled ? m_VisibleBatchCounts[b] : batch.CommandCount;
+		if (drawCount == 0)
+		{
+			continue;
+		}
+		if (m_Bindless)
+		{
+			command.pushConstants(layout.GetPipelineLayout(), vk::ShaderStageFlagBits::eFragment, 0, sizeof(uint32_t), &batch.MaterialIndex);
+			m_IndirectStats.MaterialPushes++;
+		}
+		else
+		{
+			vk::DescriptorSet set = layout.GetDescriptorSet(1, batch.MaterialIndex);
+			command.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, layout.GetPipelineLayout(), 1, 1, &set, 1, &dynamicOffset);
+			m_IndirectStats.SetBinds++;
+		}
+		if (m_GpuCulled)
+		{
+			vk::DeviceSize commandOffset = m_CulledStride * frameIndex + batch.FirstCommand * stride;
+			vk::DeviceSize countOffset = m_CountStride * frameIndex + b * sizeof(uint32_t);
+			command.drawIndexedIndirectCount(m_CulledBuffer.m_Buffer, commandOffset, m_CountBuffer.m_Buffer, countOffset, batch.CommandCount, stride);
+		}
+		else
+		{
+			vk::Buffer buffer = m_CpuCulled ? m_VisibleCommandBuffer.m_Buffer : m_IndirectBuffer.m_Buffer;
+			vk::DeviceSize commandOffset = (m_CpuCulled ? m_VisibleCommandStride * frameIndex : 0) + batch.FirstCommand * stride;
+			if (multiDraw)
+			{
+				command.drawIndexedIndirect(buffer, commandOffset, drawCount, stride);
+			}
+			else
+			{
+				//without multiDrawIndirect the draw count has to be 1
+				for (uint32_t i = 0; i < drawCount; i++)
+				{
+					command.drawIndexedIndirect(buffer, commandOffset + i * stride, 1, stride);
+				}
+			}
+		}
+		m_IndirectStats.Draws += drawCount;
+	}
+	m_GpuCulled = false;
+	m_CpuCulled = false;
 }
 
 void GlTFModel::BuildDescriptorSets()
 {
+	if (m_Bindless && BuildBindlessSet())
+	{
+		return;
+	}
 	m_DescriptorSetLayout.Bindings = {
 		//{ vk::DescriptorType::eUniformBuffer, vk::ShaderStageFlagBits::eFragment, 0 }, //pbrFactor
-		{ vk::DescriptorType::eUniformBuffer, vk::ShaderStageFlagBits::eVertex, 0 },
+		{ vk::DescriptorType::eStorageBufferDynamic, vk::ShaderStageFlagBits::eVertex, 0 }, //draw matrices
 		{ vk::DescriptorType::eCombinedImageSampler, vk::ShaderStageFlagBits::eFragment, 1 }, //BaseColorTextureIndex
 		{ vk::DescriptorType::eCombinedImageSampler, vk::ShaderStageFlagBits::eFragment, 2 }, //MetallicRoughnessTextureIndex
 		{ vk::DescriptorType::eCombinedImageSampler, vk::ShaderStageFlagBits::eFragment, 3 }, //OcclusionTextureIndex
@@ -346,11 +1110,190 @@ void GlTFModel::BuildDescriptorSets()
 	{
 		m_DescriptorSetLayout.SetWriteData.push_back({
 			//{ m_UniformBuffer.m_Descriptor, {}, false },
-			{ m_ModelMatrixs[i].m_Descriptor, {}, false},
+			{ vk::DescriptorBufferInfo(m_DrawBuffer.m_Buffer, 0, m_DrawStride), {}, false },
 			{ {}, m_Textures[m_TextureIndices[m_Materials[i].BaseColorTextureIndex].ImageIndex].GetDescriptor(), true },
 			{ {}, m_Textures[m_TextureIndices[m_Materials[i].MetallicRoughnessTextureIndex].ImageIndex].GetDescriptor(), true },
 			{ {}, m_Textures[m_TextureIndices[m_Materials[i].OcclusionTextureIndex].ImageIndex].GetDescriptor(), true },
 			{ {}, m_Textures[m_TextureIndices[m_Materials[i].NormalMapTextureIndex].ImageIndex].GetDescriptor(), true }
 		});
 	}
+}
+
+bool GlTFModel::BuildBindlessSet()
+{
+	//the texture array is update after bind, so its own limits apply rather than the per stage ones
+	const vk::PhysicalDeviceVulkan12Properties& limits = m_Device.GetProperties12();
+	m_BindlessCapacity = (std::min)({ 4096u, limits.maxPerStageDescriptorUpdateAfterBindSamplers, limits.maxPerStageDescriptorUpdateAfterBindSampledImages,
+		limits.maxDescriptorSetUpdateAfterBindSamplers, limits.maxDescriptorSetUpdateAfterBindSampledImages });
+	if (m_Textures.size() > m_BindlessCapacity)
+	{
+		std::cout << "bindless: " << m_Textures.size() << " textures exceed the limit of " << m_BindlessCapacity << ", using per material sets" << std::endl;
+		m_Bindless = false;
+		return false;
+	}
+
+	//set 1 only carries the draw matrices, every draw shares it
+	m_DescriptorSetLayout.Bindings = {
+		{ vk::DescriptorType::eStorageBufferDynamic, vk::ShaderStageFlagBits::eVertex, 0 }, //draw matrices
+	};
+	m_DescriptorSetLayout.SetCount = 1;
+	m_DescriptorSetLayout.SetWriteData.push_back({
+		{ vk::DescriptorBufferInfo(m_DrawBuffer.m_Buffer, 0, m_DrawStride), {}, false }
+	});
+
+	m_GpuMaterials.resize(m_Materials.size());
+	for (uint32_t i = 0; i < m_GpuMaterials.size(); i++)
+	{
+		const Material& material = m_Materials[i];
+		GpuMaterial& record = m_GpuMaterials[i];
+		record.BaseColorFactor = material.BaseColorFactor;
+		record.MetallicFactor = material.MetallicFactor;
+		record.RoughnessFactor = material.RoughnessFactor;
+		record.OcclusionStrength = material.OcclustionStrength;
+		record.NormalScale = material.NormalScale;
+		record.BaseColorTexture = m_TextureIndices[material.BaseColorTextureIndex].ImageIndex;
+		record.MetallicRoughnessTexture = m_TextureIndices[material.MetallicRoughnessTextureIndex].ImageIndex;
+		record.OcclusionTexture = m_TextureIndices[material.OcclusionTextureIndex].ImageIndex;
+		record.NormalMapTexture = m_TextureIndices[material.NormalMapTextureIndex].ImageIndex;
+	}
+	//room for as many streamed materials as the scene loaded, slices are written by UpdateMaterials
+	m_MaterialCapacity = (std::max)(static_cast<uint32_t>(m_GpuMaterials.size()) * 2, 64u);
+	vk::DeviceSize alignment = m_Device.GetProperties().limits.minStorageBufferOffsetAlignment;
+	m_MaterialStride = (sizeof(GpuMaterial) * m_MaterialCapacity + alignment - 1) / alignment * alignment;
+	m_MaterialBuffer.Create(m_Device, vk::BufferUsageFlagBits::eStorageBuffer, m_MaterialStride * m_FramesInFlight, vk::SharingMode::eExclusive, vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent, nullptr);
+	m_MaterialBuffer.Map();
+	m_MaterialSliceVersions.assign(m_FramesInFlight, 0);
+
+	//slot i of the array is image i, the tail is left unwritten for textures streamed in later
+	m_BindlessTextureCount = static_cast<uint32_t>(m_Textures.size());
+	DescriptorWriteData textureArray = { {}, {}, true };
+	for (auto& texture : m_Textures)
+	{
+		textureArray.ImageArray.push_back(texture.GetDescriptor());
+	}
+	vk::DescriptorBindingFlags arrayFlags = vk::DescriptorBindingFlagBits::ePartiallyBound | vk::DescriptorBindingFlagBits::eUpdateAfterBind;
+	m_BindlessSetLayout.Bindings = {
+		{ vk::DescriptorType::eStorageBuffer, vk::ShaderStageFlagBits::eFragment, 0 }, //material records
+		{ vk::DescriptorType::eCombinedImageSampler, vk::ShaderStageFlagBits::eFragment, 1, m_BindlessCapacity, arrayFlags }, //textures
+	};
+	//update after bind sets can't hold dynamic buffers, so each frame in flight gets a set on its own slice
+	m_BindlessSetLayout.SetCount = m_FramesInFlight;
+	for (uint32_t i = 0; i < m_FramesInFlight; i++)
+	{
+		m_BindlessSetLayout.SetWriteData.push_back({
+			{ vk::DescriptorBufferInfo(m_MaterialBuffer.m_Buffer, m_MaterialStride * i, m_MaterialStride), {}, false },
+			textureArray
+		});
+	}
+	return true;
+}
+
+std::vector<vk::PushConstantRange> GlTFModel::GetPushConstants()
+{
+	if (!m_Bindless)
+	{
+		return {};
+	}
+	//the material index of each draw
+	return { vk::PushConstantRange(vk::ShaderStageFlagBits::eFragment, 0, sizeof(uint32_t)) };
+}
+
+uint32_t GlTFModel::AddBindlessTexture(PipeLineLayout& layout, const vk::DescriptorImageInfo& image)
+{
+	if (!m_Bindless || m_BindlessTextureCount >= m_BindlessCapacity)
+	{
+		throw std::runtime_error("bindless texture array is full!");
+	}
+	uint32_t slot = m_BindlessTextureCount++;
+	//the slot is unused by every frame in flight, partially bound lets it be written while they run
+	for (uint32_t i = 0; i < m_FramesInFlight; i++)
+	{
+		layout.WriteImage(BindlessSetIndex, i, 1, slot, image);
+	}
+	return slot;
+}
+
+uint32_t GlTFModel::AddMaterial(const GpuMaterial& material)
+{
+	if (!m_Bindless || m_GpuMaterials.size() >= m_MaterialCapacity)
+	{
+		throw std::runtime_error("bindless material table is full!");
+	}
+	m_GpuMaterials.push_back(material);
+	m_MaterialVersion++;
+	return static_cast<uint32_t>(m_GpuMaterials.size() - 1);
+}
+
+void GlTFModel::UpdateMaterial(uint32_t index, const GpuMaterial& material)
+{
+	if (index >= m_GpuMaterials.size())
+	{
+		throw std::runtime_error("material index out of range!");
+	}
+	m_GpuMaterials[index] = material;
+	m_MaterialVersion++;
+}
+
+uint32_t GlTFModel::NodeHierarchy::Add(int32_t parent, const glm::mat4& local)
+{
+	uint32_t index = Size();
+	Parents.push_back(parent);
+	Translations.push_back(glm::vec3(0.0f));
+	Rotations.push_back(glm::quat(1.0f, 0.0f, 0.0f, 0.0f));
+	Scales.push_back(glm::vec3(1.0f));
+	LocalMatrices.push_back(local);
+	WorldMatrices.push_back(local);
+	Dirty.push_back(1);
+	return index;
+}
+
+void GlTFModel::NodeHierarchy::SetLocal(uint32_t node, const glm::vec3& translation, const glm::quat& rotation, const glm::vec3& scale)
+{
+	Translations[node] = translation;
+	Rotations[node] = rotation;
+	Scales[node] = scale;
+	LocalMatrices[node] = glm::translate(glm::mat4(1.0f), translation) * glm::mat4(rotation) * glm::scale(glm::mat4(1.0f), scale);
+	Dirty[node] = 1;
+}
+
+void GlTFModel::NodeHierarchy::SetLocal(uint32_t node, const glm::mat4& local)
+{
+	//nodes authored as a matrix keep identity TRS
+	LocalMatrices[node] = local;
+	Dirty[node] = 1;
+}
+
+bool GlTFModel::NodeHierarchy::UpdateWorld()
+{
+	uint32_t count = Size();
+	bool anyDirty = false;
+	for (uint32_t i = 0; i < count; i++)
+	{
+		int32_t parent = Parents[i];
+		if (parent >= 0 && Dirty[parent])
+		{
+			Dirty[i] = 1;
+		}
+		if (Dirty[i])
+		{
+			WorldMatrices[i] = parent >= 0 ? WorldMatrices[parent] * LocalMatrices[i] : LocalMatrices[i];
+			anyDirty = true;
+		}
+	}
+	if (anyDirty)
+	{
+		std::fill(Dirty.begin(), Dirty.end(), 0);
+	}
+	return anyDirty;
+}
+
+void GlTFModel::NodeHierarchy::Clear()
+{
+	Parents.clear();
+	Translations.clear();
+	Rotations.clear();
+	Scales.clear();
+	LocalMatrices.clear();
+	WorldMatrices.clear();
+	Dirty.clear();
 }
\ No newline at end of file
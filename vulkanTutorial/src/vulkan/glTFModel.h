@@ -4,11 +4,16 @@
 #include "Texture.h"
 #include "Buffer.h"
 #include "PipelineLayout.h"
+#include "DrawList.h"
+#include "../core/Frustum.h"
+#include "../core/MappedFile.h"
 #define TINYGLTF_NO_STB_IMAGE_WRITE
 #include "tiny_gltf.h"
 #include <glm.hpp>
 #include <gtc/matrix_transform.hpp>
+#include <gtc/quaternion.hpp>
 #include <vulkan/vulkan.hpp>
+#include <functional>
 #include <string>
 #include <vector>
 
@@ -54,24 +59,73 @@ public:
 		uint32_t MaterialIndex;
 	};
 
-	struct Mesh
+	//one drawable primitive of the node at NodeIndex, bounds are in the node's space
+	struct DrawItem
 	{
-		std::vector<Primitive> Primitives;
+		uint32_t NodeIndex;
+		Primitive Prim;
+		glm::vec3 BoundsMin;
+		glm::vec3 BoundsMax;
 	};
 
-	struct Node
+	//consecutive indirect commands drawn with one material set
+	struct IndirectBatch
 	{
-		Node* Parent;
-		std::vector<Node*> Children;
-		Mesh NodeMesh;
-		glm::mat4 ModelMatrix;
-		~Node()
-		{
-			for (auto& child : Children)
-			{
-				delete child;
-			}
-		}
+		uint32_t MaterialIndex;
+		uint32_t FirstCommand;
+		uint32_t CommandCount;
+	};
+
+	//input of the culling compute shader, one per draw item at the item's index
+	struct GpuDrawObject
+	{
+		glm::vec4 BoundsMin;
+		glm::vec4 BoundsMax;
+		uint32_t IndexCount;
+		uint32_t FirstIndex;
+		uint32_t Batch;
+		uint32_t BatchFirst;
+	};
+
+	//material record of the bindless table, texture fields are slots of the texture array
+	struct GpuMaterial
+	{
+		glm::vec4 BaseColorFactor;
+		float MetallicFactor;
+		float RoughnessFactor;
+		float OcclusionStrength;
+		float NormalScale;
+		uint32_t BaseColorTexture;
+		uint32_t MetallicRoughnessTexture;
+		uint32_t OcclusionTexture;
+		uint32_t NormalMapTexture;
+	};
+
+	struct CullConstants
+	{
+		glm::vec4 Planes[6];
+		uint32_t DrawCount;
+	};
+
+	//flat node hierarchy, a parent always comes before its children so world matrices resolve in one pass
+	struct NodeHierarchy
+	{
+		//parent of a root node
+		static constexpr int32_t NoParent = -1;
+		std::vector<int32_t> Parents;
+		std::vector<glm::vec3> Translations;
+		std::vector<glm::quat> Rotations;
+		std::vector<glm::vec3> Scales;
+		std::vector<glm::mat4> LocalMatrices;
+		std::vector<glm::mat4> WorldMatrices;
+		std::vector<uint8_t> Dirty;
+		uint32_t Add(int32_t parent, const glm::mat4& local);
+		void SetLocal(uint32_t node, const glm::vec3& translation, const glm::quat& rotation, const glm::vec3& scale);
+		void SetLocal(uint32_t node, const glm::mat4& local);
+		//recomputes dirty nodes and everything below them, true if any world matrix changed
+		bool UpdateWorld();
+		uint32_t Size() const { return static_cast<uint32_t>(Parents.size()); }
+		void Clear();
 	};
 
 	struct Material
@@ -89,11 +143,6 @@ public:
 		uint32_t EmissiveTextureIndex;
 	};
 
-	struct ModelMatrix
-	{
-		glm::mat4 matrix;
-	};
-
 	struct PBRFactor
 	{
 		glm::vec4 BaseColorFactor;
@@ -111,28 +160,87 @@ public:
 public:
 	GlTFModel() = default;
 
-	void LoadModel(Device& device, const std::string& filaname);
-	void Draw(vk::CommandBuffer command, PipeLineLayout& layout);
+	//one texture array and material table for the whole scene, set before LoadModel, needs descriptor indexing
+	void SetBindless(bool enable) { m_Bindless = enable; }
+	bool IsBindless() const { return m_Bindless; }
+	void LoadModel(Device& device, const std::string& filaname, uint32_t framesInFlight = 1);
+	void Draw(vk::CommandBuffer command, PipeLineLayout& layout, uint32_t frameIndex, vk::Pipeline pipeline);
+	//Draw recorded into secondaries of the render pass in inheritance by the job system workers,
+	//bindState binds what the caller would otherwise have bound on the primary
+	void DrawParallel(vk::CommandBuffer primary, const vk::CommandBufferInheritanceInfo& inheritance, const std::function<void(vk::CommandBuffer)>& bindState, PipeLineLayout& layout, uint32_t frameIndex, vk::Pipeline pipeline);
+	//compacts the indirect commands to the ones inside the frustum on the GPU, recorded outside the render pass before Draw
+	//without the cull pipeline Draw compacts them on the CPU instead
+	void Cull(vk::CommandBuffer command, uint32_t frameIndex);
+	//with GPU culling the draw count is an upper bound, the visible count stays on the GPU
+	const DrawListStats& GetDrawStats() const { return m_Indirect ? m_IndirectStats : m_DrawPackets.GetStats(); }
+	bool HasGpuCulling() const { return m_CullPipeline; }
+	//the cull pipeline is owned by the registry, its set by the DescriptorSetManager
+	void ReleaseCullPass() { m_CullLayout.Clear(); m_CullPipeline = nullptr; }
+	//static geometry as one indirect draw per material, needs drawIndirectFirstInstance
+	bool SetIndirect(bool enable);
+	bool IsIndirect() const { return m_Indirect; }
+	//primitives outside the frustum of viewProjection are left out of the draw list or the indirect commands
+	void SetCullMatrix(const glm::mat4& viewProjection) { m_Frustum = Frustum::FromMatrix(viewProjection); m_HasFrustum = true; }
+	void SetCulling(bool enable) { m_Culling = enable; }
+	//only counts CPU culling, a GPU culled frame leaves the stats as they were
+	const CullStats& GetCullStats() const { return m_CullStats; }
+	const BoundsSoA& GetWorldBounds() const { return m_WorldBounds; }
+	UploadTicket GetUploadTicket() { return m_UploadTicket; }
 	uint32_t GetTextureCount() { return m_Textures.size(); }
 	std::vector<Texture>& GetImages() { return m_Textures; }
 	DescriptorSetLayoutCreateInfo GetDescriptorSet() { return m_DescriptorSetLayout; }
+	//set index of the bindless set in the pipeline layout: material records and the texture array
+	static constexpr uint32_t BindlessSetIndex = 2;
+	DescriptorSetLayoutCreateInfo GetBindlessSet() { return m_BindlessSetLayout; }
+	std::vector<vk::PushConstantRange> GetPushConstants();
+	//stream a texture into a free slot of the bound texture array, returns the slot
+	uint32_t AddBindlessTexture(PipeLineLayout& layout, const vk::DescriptorImageInfo& image);
+	//stream a material record into the bindless table, returns the index pushed by its draws
+	uint32_t AddMaterial(const GpuMaterial& material);
+	//frames in flight keep reading the old record, each frame picks the change up when its slice is rewritten
+	void UpdateMaterial(uint32_t index, const GpuMaterial& material);
+	NodeHierarchy& GetNodes() { return m_Hierarchy; }
 	~GlTFModel()
 	{
 		m_VertexBuffer.Clear();
 		m_IndexBuffer.Clear();
+		m_DrawBuffer.Clear();
+		m_MaterialBuffer.Clear();
+		m_IndirectBuffer.Clear();
+		m_VisibleCommandBuffer.Clear();
+		m_ObjectBuffer.Clear();
+		m_CulledBuffer.Clear();
+		m_CountBuffer.Clear();
 		for (auto& image : m_Textures)
 		{
 			image.Clear();
 		}
 	}
 private:
+	void ParseGlTF(const std::string& filename);
+	bool LoadCooked(const std::string& cookedPath);
+	void WriteCooked(const std::string& cookedPath);
+	void CreateGeometryBuffers(const void* vertices, vk::DeviceSize vertexSize, const void* indices, vk::DeviceSize indexSize);
 	void LoadImages();
 	void LoadMaterials();
 	void loadTextures();
-	void LoadNode(const tinygltf::Node& inputNode, GlTFModel::Node* parent);
-	void DrawNode(Node* node, vk::CommandBuffer command, PipeLineLayout& layout);
-	void UpdateUniforms(uint32_t matId, glm::mat4 modelMatrix);
+	void LoadNode(const tinygltf::Node& inputNode, int32_t parent);
 	void BuildDescriptorSets();
+	//false when the scene doesn't fit the update after bind limits, the model then falls back to per material sets
+	bool BuildBindlessSet();
+	void BuildIndirectCommands();
+	void UpdateWorldBounds();
+	void UpdateDrawMatrices(uint32_t frameIndex);
+	void UpdateMaterials(uint32_t frameIndex);
+	//indices of the draw items inside the frustum into m_Visible, every item when culling is off
+	void CullVisible();
+	//visible primitives into the sorted draw list
+	void BuildDrawPackets(PipeLineLayout& layout, vk::Pipeline pipeline);
+	//visible indirect commands compacted to the front of their batch in this frame's slice, when the GPU didn't cull
+	void WriteVisibleCommands(uint32_t frameIndex);
+	void BindGeometry(vk::CommandBuffer command, PipeLineLayout& layout, uint32_t frameIndex);
+	void BuildCullPass(const std::vector<GpuDrawObject>& objects);
+	void DrawIndirect(vk::CommandBuffer command, PipeLineLayout& layout, uint32_t frameIndex, vk::Pipeline pipeline);
 	
 private:
 	Device m_Device;
@@ -141,15 +249,67 @@ private:
 	std::string err;
 	std::string warning;
 	DescriptorSetLayoutCreateInfo m_DescriptorSetLayout;
+	DescriptorSetLayoutCreateInfo m_BindlessSetLayout;
+	bool m_Bindless = false;
+	//material table, one slice per frame in flight with spare records for streamed materials
+	Buffer m_MaterialBuffer;
+	vk::DeviceSize m_MaterialStride = 0;
+	std::vector<GpuMaterial> m_GpuMaterials;
+	uint32_t m_MaterialCapacity = 0;
+	uint32_t m_MaterialVersion = 1;
+	std::vector<uint32_t> m_MaterialSliceVersions;
+	uint32_t m_BindlessCapacity = 0;
+	uint32_t m_BindlessTextureCount = 0;
 	std::vector<Texture> m_Textures;
+	//external image uris and source files relative to the model directory
+	std::string m_BaseDir;
+	std::vector<std::string> m_ImageUris;
+	std::vector<std::string> m_Dependencies;
 	std::vector<GlTFModel::TextureIndex> m_TextureIndices;
 	std::vector<Material> m_Materials;
 	std::vector<PBRFactor> m_PBRFactors;
-	std::vector<Node*> m_Nodes;
+	NodeHierarchy m_Hierarchy;
+	std::vector<DrawItem> m_DrawList;
+	DrawList m_DrawPackets;
+	Buffer m_IndirectBuffer;
+	std::vector<vk::DrawIndexedIndirectCommand> m_IndirectCommands;
+	std::vector<IndirectBatch> m_IndirectBatches;
+	//CPU culling of the indirect commands: host visible, one slice per frame in flight laid out like m_IndirectBuffer
+	Buffer m_VisibleCommandBuffer;
+	vk::DeviceSize m_VisibleCommandStride = 0;
+	std::vector<uint32_t> m_VisibleBatchCounts;
+	std::vector<uint8_t> m_VisibleFlags;
+	bool m_CpuCulled = false;
+	DrawListStats m_IndirectStats;
+	bool m_Indirect = false;
+	BoundsSoA m_WorldBounds;
+	std::vector<uint32_t> m_Visible;
+	//per range results of a parallel cull, kept to reuse their storage
+	std::vector<std::vector<uint32_t>> m_ChunkVisible;
+	Frustum m_Frustum;
+	bool m_HasFrustum = false;
+	bool m_Culling = true;
+	CullStats m_CullStats;
+	//GPU culling: static objects in, compacted commands and one count per batch out, one slice per frame in flight
+	Buffer m_ObjectBuffer;
+	Buffer m_CulledBuffer;
+	Buffer m_CountBuffer;
+	vk::DeviceSize m_CulledStride = 0;
+	vk::DeviceSize m_CountStride = 0;
+	PipeLineLayout m_CullLayout;
+	vk::Pipeline m_CullPipeline;
+	bool m_GpuCulled = false;
 	Buffer m_VertexBuffer;
 	Buffer m_IndexBuffer;
 	Buffer m_UniformBuffer;
-	std::vector<Buffer> m_ModelMatrixs;
+	//world matrix of every draw item, one slice per frame in flight
+	Buffer m_DrawBuffer;
+	vk::DeviceSize m_DrawStride = 0;
+	uint32_t m_FramesInFlight = 1;
+	//bumped when any world matrix moves, a slice is only rewritten when it is behind
+	uint32_t m_TransformVersion = 1;
+	std::vector<uint32_t> m_SliceVersions;
 	std::vector<uint32_t> m_Indices;
 	std::vector<GlTFModel::Vertex> m_Vertices;
+	UploadTicket m_UploadTicket = 0;
 };
\ No newline at end of file